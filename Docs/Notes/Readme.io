@@ -12,6 +12,8 @@ directories are named *.temp until complete.
 
 demand driven reads.
 headers contain min/max and seek for each grid (VisMF Header Versions 1 and 3).
+VisMF Header Version 5 writes each grid as a compressed block, lossy if a
+compression tolerance is set (plotfiles only, checkpoints are always lossless).
 data is addressable to a single component of a single grid.
 no restriction on the relationship between nprocs and nfiles for reading.
 stream throttling for reading to prevent thrashing.
@@ -29,11 +31,14 @@ vismf.usepersistentifstreams  (def:  true)
 vismf.usesynchronousreads     (def:  false)
 vismf.usedynamicsetselection  (def:  true)
 vismf.iobuffersize            (def:  VisMF::IO_Buffer_Size)
+vismf.compressiontolerance    (def:  0.0  lossless)
+vismf.usememorymappedreads    (def:  false)
 amr.plot_nfiles               (def:  64)
 amr.checkpoint_nfiles         (def:  64)
 amr.mffile_nstreams           (def:  1)
 amr.plot_headerversion        (def:  Version_v1  (1) )
 amr.checkpoint_headerversion  (def:  Version_v1  (1) )
+amr.plot_compressiontolerance (def:  0.0  lossless)
 amr.prereadFAHeaders          (def:  true)
 amr.precreateDirectories      (def:  true)
 
@@ -82,6 +82,7 @@ namespace
     int  checkpoint_nfiles;
     int  regrid_on_restart;
     int  use_efficient_regrid;
+    int  async_regrid;
     int  plotfile_on_restart;
     int  insitu_on_restart;
     int  checkpoint_on_restart;
@@ -90,6 +91,7 @@ namespace
     bool prereadFAHeaders;
     VisMF::Header::Version plot_headerversion(VisMF::Header::Version_v1);
     VisMF::Header::Version checkpoint_headerversion(VisMF::Header::Version_v1);
+    Real plot_compressiontolerance(0.0);
 }
 
 
@@ -118,6 +120,7 @@ Amr::Initialize ()
     checkpoint_nfiles        = 64;
     regrid_on_restart        = 0;
     use_efficient_regrid     = 0;
+    async_regrid             = 0;
     plotfile_on_restart      = 0;
     insitu_on_restart        = 0;
     checkpoint_on_restart    = 0;
@@ -127,6 +130,7 @@ Amr::Initialize ()
     prereadFAHeaders         = true;
     plot_headerversion       = VisMF::Header::Version_v1;
     checkpoint_headerversion = VisMF::Header::Version_v1;
+    plot_compressiontolerance = 0.0;
 #if defined(AMREX_USE_SENSEI_INSITU) && !defined(AMREX_NO_SENSEI_AMR_INST)
     insitu_bridge            = nullptr;
 #endif
@@ -258,6 +262,7 @@ Amr::InitAmr ()
     //
     pp.queryAdd("regrid_on_restart",regrid_on_restart);
     pp.queryAdd("use_efficient_regrid",use_efficient_regrid);
+    pp.queryAdd("async_regrid",async_regrid);
     pp.queryAdd("plotfile_on_restart",plotfile_on_restart);
     pp.queryAdd("insitu_on_restart",insitu_on_restart);
     pp.queryAdd("checkpoint_on_restart",checkpoint_on_restart);
@@ -939,6 +944,8 @@ Amr::writePlotFileDoit (std::string const& pltfile, bool regular)
     VisMF::SetNOutFiles(plot_nfiles);
     VisMF::Header::Version currentVersion(VisMF::GetHeaderVersion());
     VisMF::SetHeaderVersion(plot_headerversion);
+    Real currentTolerance(VisMF::GetCompressionTolerance());
+    VisMF::SetCompressionTolerance(plot_compressiontolerance);
 
     amrex::StreamRetry sretry(pltfile, abort_on_stream_retry_failure,
                               stream_max_tries);
@@ -1048,6 +1055,7 @@ Amr::writePlotFileDoit (std::string const& pltfile, bool regular)
     }  // end while
 
     VisMF::SetHeaderVersion(currentVersion);
+    VisMF::SetCompressionTolerance(currentTolerance);
 }
 
 void
@@ -1720,6 +1728,9 @@ Amr::checkPoint ()
 
     VisMF::Header::Version currentVersion(VisMF::GetHeaderVersion());
     VisMF::SetHeaderVersion(checkpoint_headerversion);
+    // ---- checkpoints are never written lossy
+    Real currentTolerance(VisMF::GetCompressionTolerance());
+    VisMF::SetCompressionTolerance(0.0);
 
     auto dCheckPointTime0 = amrex::second();
 
@@ -1879,6 +1890,7 @@ Amr::checkPoint ()
   FArrayBox::setFormat(thePrevFormat);
 
   VisMF::SetHeaderVersion(currentVersion);
+  VisMF::SetCompressionTolerance(currentTolerance);
 
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
@@ -2607,6 +2619,61 @@ Amr::regrid (int  lbase,
 
     finest_level = new_finest;
 
+    auto make_dmap = [&] (int lev)
+    {
+        if (loadbalance_with_workestimates && !initial) {
+            new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
+        }
+        else if (new_dmap[lev].empty()) {
+            if (use_incremental_regrid && amr_level[lev]) {
+                new_dmap[lev] = DistributionMapping::makeIncremental(new_grid_places[lev],
+                                                                     amr_level[lev]->boxArray(),
+                                                                     amr_level[lev]->DistributionMap());
+            } else {
+                new_dmap[lev].define(new_grid_places[lev]);
+            }
+        }
+    };
+
+    //
+    // With async_regrid, the new-time data of the levels that existed
+    // before are allocated on the new grids first, and the copies of the
+    // data of all their state types from the old levels are started at
+    // once.  They proceed while the DistributionMappings of the finer
+    // levels are made and the coarser levels are filled from the next
+    // coarser ones.  Each new level then takes over its data when it is
+    // constructed.  With use_incremental_regrid, this is also done so that
+    // the new levels keep the FABs of the boxes that stay on their process.
+    //
+    Vector<int> regrid_filled(new_finest+1, 0);
+
+    if ((async_regrid || use_incremental_regrid) && !initial && !loadbalance_with_workestimates)
+    {
+        for (int lev = start; lev <= new_finest; ++lev)
+        {
+            if (!amr_level[lev]) continue;
+
+            if (!amr_level[lev]->hasInitAfterRegridFill())
+            {
+                static bool warned = false;
+                if (async_regrid && !warned) {
+                    warned = true;
+                    amrex::Print() << "Warning: amr.async_regrid is ignored because the AmrLevel"
+                                   << " class does not override initAfterRegridFill\n";
+                }
+                break;
+            }
+
+            if (amr_level[lev]->canRegridFill())
+            {
+                make_dmap(lev);
+                amr_level[lev]->startRegridFill(new_grid_places[lev], new_dmap[lev],
+                                                use_incremental_regrid);
+                regrid_filled[lev] = 1;
+            }
+        }
+    }
+
     //
     // Define the new grids from level start up to new_finest.
     //
@@ -2615,13 +2682,11 @@ Amr::regrid (int  lbase,
         // Construct skeleton of new level.
         //
 
-        if (loadbalance_with_workestimates && !initial) {
-            new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
-        }
-        else if (new_dmap[lev].empty()) {
-            new_dmap[lev].define(new_grid_places[lev]);
+        if (regrid_filled[lev]) {
+            amr_level[lev]->finishRegridFill();
         }
 
+        make_dmap(lev);
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
                                   new_dmap[lev],cumtime);
 
@@ -2644,7 +2709,11 @@ Amr::regrid (int  lbase,
             // NOTE: The init function may use a filPatch from the old level,
             //       which therefore needs remain in the hierarchy during the call.
             //
-            a->init(*amr_level[lev]);
+            if (regrid_filled[lev]) {
+                a->initAfterRegridFill(*amr_level[lev]);
+            } else {
+                a->init(*amr_level[lev]);
+            }
             amr_level[lev].reset(a);
             this->SetBoxArray(lev, amr_level[lev]->boxArray());
             this->SetDistributionMap(lev, amr_level[lev]->DistributionMap());
@@ -2770,6 +2839,15 @@ Amr::LoadBalanceLevel0 (Real time)
     amr_level[0]->post_regrid(0,0);
 }
 
+void
+Amr::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const DistributionMapping& dm)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ba == boxArray(lev),
+                                     "Amr::RemakeLevel: only a new DistributionMapping is supported");
+    InstallNewDistributionMap(lev, dm);
+    amr_level[lev]->post_regrid(lev, finest_level);
+}
+
 void
 Amr::InstallNewDistributionMap (int lev, const DistributionMapping& newdm)
 {
@@ -3262,6 +3340,7 @@ Amr::initPltAndChk ()
     if(chvInt != checkpoint_headerversion) {
       checkpoint_headerversion = static_cast<VisMF::Header::Version> (chvInt);
     }
+    pp.queryAdd("plot_compressiontolerance", plot_compressiontolerance);
 }
 
 
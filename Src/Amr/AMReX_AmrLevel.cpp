@@ -16,6 +16,7 @@
 #endif
 
 #include <sstream>
+#include <algorithm>
 #include <memory>
 #include <limits>
 
@@ -103,17 +104,21 @@ AmrLevel::AmrLevel (Amr&            papa,
 
     state.resize(desc_lst.size());
 
-#ifdef AMREX_USE_EB
-    if (EB2::TopIndexSpaceIfPresent()) {
-        m_factory = makeEBFabFactory(geom, ba, dm,
-                                     {m_eb_basic_grow_cells,
-                                      m_eb_volume_grow_cells,
-                                      m_eb_full_grow_cells},
-                                     m_eb_support_level);
-    } else
-#endif
+    //
+    // Take over the new-time data that Amr::regrid has filled from the
+    // level this one replaces.
+    //
+    std::unique_ptr<RegridFill> regrid_fill;
+    auto& levels = parent->getAmrLevels();
+    if (level < levels.size() && levels[level] && levels[level]->m_regrid_fill &&
+        levels[level]->m_regrid_fill->grids == ba && levels[level]->m_regrid_fill->dmap == dm)
     {
-        m_factory = std::make_unique<FArrayBoxFactory>();
+        regrid_fill = std::move(levels[level]->m_regrid_fill);
+        m_factory = std::move(regrid_fill->factory);
+    }
+    else
+    {
+        m_factory = makeFabFactory(ba, dm);
     }
 
     // Note that this creates a distribution map associated with grids.
@@ -129,7 +134,8 @@ AmrLevel::AmrLevel (Amr&            papa,
                         desc_lst[i],
                         time,
                         parent->dtLevel(lev),
-                        *m_factory);
+                        *m_factory,
+                        regrid_fill ? std::move(regrid_fill->new_data[i]) : nullptr);
     }
 
     if (parent->useFixedCoarseGrids()) constructAreaNotToTag();
@@ -721,6 +727,27 @@ FillPatchIterator::FillPatchIterator (AmrLevel& amrlevel,
 #endif
 }
 
+FillPatchIterator::FillPatchIterator (AmrLevel&          amrlevel,
+                                      MultiFab&          leveldata,
+                                      int                boxGrow,
+                                      Real               time,
+                                      const Vector<int>& idx,
+                                      const Vector<int>& scomp,
+                                      const Vector<int>& ncomp)
+    :
+    MFIter(leveldata),
+    m_amrlevel(amrlevel),
+    m_leveldata(leveldata),
+    m_ncomp(0)
+{
+    MFIter::depth = 0;
+    Initialize(boxGrow,time,idx,scomp,ncomp);
+
+#ifdef BL_USE_TEAM
+    ParallelDescriptor::MyTeam().MemoryBarrier();
+#endif
+}
+
 static
 bool
 NeedToTouchUpPhysCorners (const Geometry& geom)
@@ -1149,6 +1176,330 @@ FillPatchIterator::FillFromTwoLevels (Real time, int idx, int scomp, int dcomp,
                               desc.getBCs(),scomp);
 }
 
+//
+// Copies, or interpolates in time, the valid region of the state data.  If
+// src_index is not empty, grid i of dst is grid src_index[i] of the state
+// data; otherwise dst is on the grids of the state data.
+//
+static
+void
+CopyStateData (MultiFab&                dst,
+               int                      dcomp,
+               const Vector<MultiFab*>& smf,
+               const Vector<Real>&      stime,
+               int                      scomp,
+               int                      ncomp,
+               Real                     time,
+               const Vector<int>&       src_index = Vector<int>())
+{
+    if (smf.size() > 2) {
+        amrex::Abort("FillPatchIterator: high-order interpolation in time not implemented yet");
+    }
+
+    const MultiFab* smf0 = smf[0];
+    const MultiFab* smf1 = nullptr;
+    Real alpha = 1.0, beta = 0.0;
+
+    if (smf.size() == 2 && time != stime[0])
+    {
+        const Real t0 = stime[0];
+        const Real t1 = stime[1];
+        if (time == t1) {
+            smf0 = smf[1];
+        } else if (! amrex::almostEqual(t0,t1)) {
+            smf1 = smf[1];
+            alpha = (t1-time)/(t1-t0);
+            beta = (time-t0)/(t1-t0);
+        }
+    }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const int si = src_index.empty() ? mfi.index() : src_index[mfi.index()];
+        const Box& bx = mfi.tilebox();
+        auto       dfab  = dst.array(mfi,dcomp);
+        auto const sfab0 = smf0->const_array(si,scomp);
+
+        if (smf1)
+        {
+            auto const sfab1 = smf1->const_array(si,scomp);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                dfab(i,j,k,n) = alpha*sfab0(i,j,k,n) + beta*sfab1(i,j,k,n);
+            });
+        }
+        else
+        {
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                dfab(i,j,k,n) = sfab0(i,j,k,n);
+            });
+        }
+    }
+}
+
+void
+FillPatchIterator::Initialize (int                boxGrow,
+                               Real               time,
+                               const Vector<int>& idx,
+                               const Vector<int>& scomp,
+                               const Vector<int>& ncomp)
+{
+    BL_PROFILE("FillPatchIterator::Initialize(batched)");
+
+    const int nstates = idx.size();
+
+    AMREX_ALWAYS_ASSERT(static_cast<int>(scomp.size()) == nstates &&
+                        static_cast<int>(ncomp.size()) == nstates);
+
+    m_ncomp = 0;
+    for (int i = 0; i < nstates; ++i)
+    {
+        BL_ASSERT(0 <= idx[i] && idx[i] < AmrLevel::desc_lst.size());
+        BL_ASSERT(AmrLevel::desc_lst[idx[i]].inRange(scomp[i],ncomp[i]));
+        m_ncomp += ncomp[i];
+    }
+    m_range.clear();
+
+    m_fabs.define(m_leveldata.boxArray(),m_leveldata.DistributionMap(),
+                  m_ncomp,boxGrow,MFInfo(),m_leveldata.Factory());
+
+    const Geometry& geom = m_amrlevel.Geom();
+
+    m_fabs.setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), geom);
+
+    const IndexType& boxType = m_leveldata.boxArray().ixType();
+    const int level = m_amrlevel.level;
+    //
+    // A state type is filled with the others if its data live on the grids
+    // of leveldata and, above level 1, it can be filled from the next
+    // coarser level alone.
+    //
+    Vector<FillPiece> batched;
+    Vector<int> is_batched(nstates, 0);
+    const StateData* crse_ref = nullptr;
+
+    for (int i = 0, DComp = 0; i < nstates; DComp += ncomp[i], ++i)
+    {
+        const StateDescriptor& desc = AmrLevel::desc_lst[idx[i]];
+        const StateData& statedata = m_amrlevel.state[idx[i]];
+        const auto range = desc.sameInterps(scomp[i],ncomp[i]);
+
+        bool batch = statedata.boxArray() == m_leveldata.boxArray() &&
+                     statedata.DistributionMap() == m_leveldata.DistributionMap();
+
+        if (batch && level > 0)
+        {
+            const StateData& crse_statedata = m_amrlevel.parent->getLevel(level-1).state[idx[i]];
+            if (crse_ref == nullptr) {
+                crse_ref = &crse_statedata;
+            }
+            batch = crse_statedata.boxArray() == crse_ref->boxArray() &&
+                    crse_statedata.DistributionMap() == crse_ref->DistributionMap();
+
+            for (auto const& r : range) {
+                batch = batch && (level == 1 ||
+                                  amrex::ProperlyNested(m_amrlevel.crse_ratio,
+                                                        m_amrlevel.parent->blockingFactor(level),
+                                                        boxGrow, boxType, desc.interp(r.first)));
+            }
+        }
+
+        if (batch)
+        {
+            is_batched[i] = 1;
+            for (auto const& r : range) {
+                batched.push_back({idx[i], r.first, DComp + r.first - scomp[i], r.second});
+            }
+        }
+        else
+        {
+            FillPatchIterator fpi(m_amrlevel, m_leveldata, boxGrow, time, idx[i], scomp[i], ncomp[i]);
+            MultiFab::Copy(m_fabs, fpi.get_mf(), 0, DComp, ncomp[i], boxGrow);
+        }
+    }
+
+    if (batched.empty()) return;
+
+    if (level > 0 && boxGrow > 0) {
+        FillFromCoarse(m_fabs, m_amrlevel, time, boxGrow, batched);
+    }
+
+    FillBatchedFromLevel(time, boxGrow, batched);
+    //
+    // Call hack to touch up fillPatched data.
+    //
+    for (int i = 0, DComp = 0; i < nstates; DComp += ncomp[i], ++i)
+    {
+        if (is_batched[i]) {
+            m_amrlevel.set_preferred_boundary_values(m_fabs,
+                                                     idx[i],
+                                                     scomp[i],
+                                                     DComp,
+                                                     ncomp[i],
+                                                     time);
+        }
+    }
+}
+
+void
+FillPatchIterator::FillFromCoarse (MultiFab& mf, AmrLevel& fine_level, Real time, int boxGrow,
+                                   const Vector<FillPiece>& pieces)
+{
+    BL_PROFILE("FillPatchIterator::FillFromCoarse");
+
+    AmrLevel& crse_level = fine_level.parent->getLevel(fine_level.level-1);
+
+    const Geometry& geom_fine = fine_level.geom;
+    const Geometry& geom_crse = crse_level.geom;
+    const IntVect& ratio = crse_level.fineRatio();
+    const IntVect nghost(boxGrow);
+
+    const MultiFab& fmf = fine_level.state[pieces[0].index].newData();
+    const MultiFab& cmf = crse_level.state[pieces[0].index].newData();
+
+#ifdef AMREX_USE_EB
+    EB2::IndexSpace const* index_space = EB2::TopIndexSpaceIfPresent();
+#else
+    EB2::IndexSpace const* index_space = nullptr;
+#endif
+
+    Vector<InterpBase*> mappers;
+    for (auto const& p : pieces)
+    {
+        InterpBase* mapper = AmrLevel::desc_lst[p.index].interp(p.scomp);
+        if (std::find(mappers.begin(), mappers.end(), mapper) == mappers.end()) {
+            mappers.push_back(mapper);
+        }
+    }
+    //
+    // The pieces with the same interpolater share the patches, so that
+    // their coarse data are sent together, and so are the interpolated data.
+    //
+    for (InterpBase* mapper : mappers)
+    {
+        Vector<FillPiece> group;
+        int ncomp = 0;
+        for (auto const& p : pieces)
+        {
+            if (AmrLevel::desc_lst[p.index].interp(p.scomp) == mapper) {
+                group.push_back(p);
+                ncomp += p.ncomp;
+            }
+        }
+
+        const FabArrayBase::FPinfo& fpc = FabArrayBase::TheFPinfo(fmf, mf, nghost,
+                                                                  mapper->BoxCoarsener(ratio),
+                                                                  geom_fine, geom_crse,
+                                                                  index_space);
+        if (fpc.ba_crse_patch.empty()) continue;
+
+        //
+        // The coarse data are packed into one MultiFab, which only has the
+        // coarse grids the patches are copied from, on their processes.
+        // With fabarray.cache_fillpatch_data = 1, it and the patches are kept
+        // with fpc, and so are the plans of the copies between them.
+        //
+        const auto& cg = fpc.getCrseGrids(cmf.boxArray(), cmf.DistributionMap(),
+                                          geom_crse.periodicity());
+        const IndexType ixtype = mf.ixType();
+        MultiFab crse_patch_tmp, crse_data_tmp, fine_patch_tmp;
+        MultiFab& crse_patch = get_fp_patch(fpc, fp_crse_patch, ncomp, ixtype, crse_patch_tmp,
+            [&] () { return MultiFab(fpc.ba_crse_patch, fpc.dm_patch, ncomp, 0, MFInfo(),
+                                     *fpc.fact_crse_patch); });
+        crse_patch.setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), geom_crse);
+        MultiFab& crse_data = get_fp_patch(fpc, fp_crse_data, ncomp, ixtype, crse_data_tmp,
+            [&] () { return MultiFab(cg.ba, cg.dm, ncomp, 0); });
+
+        for (int ig = 0, ccomp = 0; ig < static_cast<int>(group.size()); ccomp += group[ig].ncomp, ++ig)
+        {
+            const FillPiece& p = group[ig];
+            Vector<MultiFab*> smf_crse;
+            Vector<Real> stime_crse;
+            crse_level.state[p.index].getData(smf_crse,stime_crse,time);
+            CopyStateData(crse_data, ccomp, smf_crse, stime_crse, p.scomp, p.ncomp, time, cg.index);
+        }
+
+        crse_patch.ParallelCopy(crse_data, 0, 0, ncomp, IntVect{0}, IntVect{0}, geom_crse.periodicity());
+
+        MultiFab& fine_patch = get_fp_patch(fpc, fp_fine_patch, ncomp, ixtype, fine_patch_tmp,
+            [&] () { return MultiFab(fpc.ba_fine_patch, fpc.dm_patch, ncomp, 0, MFInfo(),
+                                     *fpc.fact_fine_patch); });
+
+        const Box& dest_domain = amrex::grow(amrex::convert(geom_fine.Domain(),mf.ixType()),nghost);
+
+        for (int ig = 0, ccomp = 0; ig < static_cast<int>(group.size()); ccomp += group[ig].ncomp, ++ig)
+        {
+            const FillPiece& p = group[ig];
+            StateDataPhysBCFunct physbcf_crse(crse_level.state[p.index],p.scomp,geom_crse);
+            physbcf_crse(crse_patch, ccomp, p.ncomp, IntVect{0}, time, p.scomp);
+
+            amrex::FillPatchInterp(fine_patch, ccomp, crse_patch, ccomp, p.ncomp, IntVect(0),
+                                   geom_crse, geom_fine, dest_domain, ratio, mapper,
+                                   AmrLevel::desc_lst[p.index].getBCs(), p.scomp);
+        }
+        //
+        // One ParallelCopy for each run of pieces adjacent in mf.
+        //
+        for (int ig = 0, ccomp = 0; ig < static_cast<int>(group.size()); )
+        {
+            const int dcomp = group[ig].dcomp;
+            const int fcomp = ccomp;
+            int n = 0;
+            do {
+                n += group[ig].ncomp;
+                ccomp += group[ig].ncomp;
+                ++ig;
+            } while (ig < static_cast<int>(group.size()) && group[ig].dcomp == dcomp + n);
+
+            mf.ParallelCopy(fine_patch, fcomp, dcomp, n, IntVect{0}, nghost);
+        }
+    }
+}
+
+void
+FillPatchIterator::FillBatchedFromLevel (Real time, int boxGrow, const Vector<FillPiece>& pieces)
+{
+    BL_PROFILE("FillPatchIterator::FillBatchedFromLevel");
+
+    const Geometry& geom = m_amrlevel.geom;
+
+    for (auto const& p : pieces)
+    {
+        Vector<MultiFab*> smf;
+        Vector<Real> stime;
+        m_amrlevel.state[p.index].getData(smf,stime,time);
+        CopyStateData(m_fabs, p.dcomp, smf, stime, p.scomp, p.ncomp, time);
+    }
+    //
+    // m_fabs is on the grids of the state data, so this is what
+    // FillPatchSingleLevel does for each of them.  The components of the
+    // state types that are not batched, which may lie between the pieces,
+    // are already filled, so there is one FillBoundary for each run of
+    // adjacent pieces.
+    //
+    for (int ip = 0, np = pieces.size(); ip < np; )
+    {
+        const int dcomp = pieces[ip].dcomp;
+        int n = 0;
+        do {
+            n += pieces[ip].ncomp;
+            ++ip;
+        } while (ip < np && pieces[ip].dcomp == dcomp + n);
+
+        m_fabs.FillBoundary(dcomp, n, IntVect(boxGrow), geom.periodicity());
+    }
+
+    for (auto const& p : pieces)
+    {
+        StateDataPhysBCFunct physbcf(m_amrlevel.state[p.index],p.scomp,geom);
+        physbcf(m_fabs, p.dcomp, p.ncomp, IntVect(boxGrow), time, p.scomp);
+    }
+}
+
 static
 bool
 HasPhysBndry (const Box&      b,
@@ -2113,6 +2464,23 @@ AmrLevel::FillPatch (AmrLevel& amrlevel,
     MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+void
+AmrLevel::FillPatch (AmrLevel&          amrlevel,
+                     MultiFab&          leveldata,
+                     int                boxGrow,
+                     Real               time,
+                     const Vector<int>& index,
+                     const Vector<int>& scomp,
+                     const Vector<int>& ncomp,
+                     int                dcomp)
+{
+    BL_ASSERT(boxGrow <= leveldata.nGrow());
+    FillPatchIterator fpi(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp);
+    const MultiFab& mf_fillpatched = fpi.get_mf();
+    BL_ASSERT(dcomp+mf_fillpatched.nComp()-1 <= leveldata.nComp());
+    MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, mf_fillpatched.nComp(), boxGrow);
+}
+
 void
 AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
                         MultiFab& leveldata,
@@ -2130,6 +2498,198 @@ AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
     MultiFab::Add(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+void
+AmrLevel::initAfterRegridFill (AmrLevel& /*old*/)
+{
+    amrex::Abort("AmrLevel::initAfterRegridFill must be overridden if hasInitAfterRegridFill is");
+}
+
+std::unique_ptr<FabFactory<FArrayBox> >
+AmrLevel::makeFabFactory (const BoxArray& ba, const DistributionMapping& dm) const
+{
+#ifdef AMREX_USE_EB
+    if (EB2::TopIndexSpaceIfPresent()) {
+        return makeEBFabFactory(geom, ba, dm,
+                                {m_eb_basic_grow_cells,
+                                 m_eb_volume_grow_cells,
+                                 m_eb_full_grow_cells},
+                                m_eb_support_level);
+    } else
+#endif
+    {
+        amrex::ignore_unused(ba,dm);
+        return std::make_unique<FArrayBoxFactory>();
+    }
+}
+
+bool
+AmrLevel::canRegridFill () const
+{
+    for (int i = 0; i < desc_lst.size(); ++i)
+    {
+        const StateDescriptor& desc = desc_lst[i];
+        const IndexType& typ = desc.getType();
+
+        if (!state[i].hasNewData()) return false;
+        //
+        // Face-centered data are filled differently from the coarse level.
+        //
+        if (AMREX_D_TERM(typ.nodeCentered(0), + typ.nodeCentered(1), + typ.nodeCentered(2)) == 1) {
+            return false;
+        }
+
+        if (level > 1)
+        {
+            for (auto const& r : desc.sameInterps(0,desc.nComp()))
+            {
+                if (!amrex::ProperlyNested(crse_ratio, parent->blockingFactor(level),
+                                           0, typ, desc.interp(r.first))) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void
+AmrLevel::startRegridFill (const BoxArray& ba, const DistributionMapping& dm, bool keep_fabs)
+{
+    BL_PROFILE("AmrLevel::startRegridFill()");
+
+    m_regrid_fill = std::make_unique<RegridFill>();
+    m_regrid_fill->grids = ba;
+    m_regrid_fill->dmap = dm;
+    m_regrid_fill->factory = makeFabFactory(ba, dm);
+
+    //
+    // The boxes that stay on their process keep their FABs, unless these
+    // are EBFArrayBoxes, which belong to the EB data of this level.  The
+    // copies only go to the other boxes, which cannot overlap the kept ones.
+    //
+    Vector<int> old_index;
+    BoxArray changed_grids;
+    DistributionMapping changed_dmap;
+    if (keep_fabs && dynamic_cast<FArrayBoxFactory const*>(m_factory.get()))
+    {
+        old_index = amrex::SameBoxIndices(ba, dm, grids, dmap);
+        BoxList bl;
+        Vector<int> pmap;
+        for (int k = 0; k < ba.size(); ++k) {
+            if (old_index[k] < 0) {
+                bl.push_back(ba[k]);
+                pmap.push_back(dm[k]);
+                m_regrid_fill->changed_index.push_back(k);
+            }
+        }
+        if (m_regrid_fill->changed_index.size() == ba.size()) {
+            old_index.clear();
+            m_regrid_fill->changed_index.clear();
+        } else if (!bl.isEmpty()) {
+            changed_grids = BoxArray(std::move(bl));
+            changed_dmap = DistributionMapping(std::move(pmap));
+        }
+    }
+
+    for (int i = 0; i < desc_lst.size(); ++i)
+    {
+        // The same tags as the state data made by the constructor
+        MultiFab::RegionTag statedata_tag("StateData_Level_" + std::to_string(level));
+        MultiFab::RegionTag statedata_index_tag("StateData_" + std::to_string(i) + "_Level_" + std::to_string(level));
+        MultiFab::RegionTag statedata_index_new_tag("StateData_" + std::to_string(i) + "_New_Level_" + std::to_string(level));
+        MultiFab::RegionTag level_tag("AmrLevel_Level_" + std::to_string(level));
+
+        const StateDescriptor& desc = desc_lst[i];
+        MultiFab& old_new = state[i].newData();
+
+        if (old_index.empty())
+        {
+            m_regrid_fill->new_data.push_back(
+                std::make_unique<MultiFab>(amrex::convert(ba, desc.getType()), dm, desc.nComp(),
+                                           desc.nExtra(), MFInfo().SetTag("StateData"),
+                                           *m_regrid_fill->factory));
+            MultiFab& S_new = *m_regrid_fill->new_data.back();
+            S_new.ParallelCopy_nowait(old_new, 0, 0, S_new.nComp(),
+                                      IntVect{0}, IntVect{0}, geom.periodicity());
+            continue;
+        }
+
+        m_regrid_fill->new_data.push_back(
+            std::make_unique<MultiFab>(amrex::convert(ba, desc.getType()), dm, desc.nComp(),
+                                       desc.nExtra(), MFInfo().SetAlloc(false).SetTag("StateData"),
+                                       *m_regrid_fill->factory));
+        MultiFab& S_new = *m_regrid_fill->new_data.back();
+
+        m_regrid_fill->changed_data.emplace_back();
+        if (!m_regrid_fill->changed_index.empty())
+        {
+            m_regrid_fill->changed_data.back() =
+                std::make_unique<MultiFab>(amrex::convert(changed_grids, desc.getType()),
+                                           changed_dmap, desc.nComp(), desc.nExtra(),
+                                           MFInfo().SetTag("StateData"), *m_regrid_fill->factory);
+            MultiFab& changed = *m_regrid_fill->changed_data.back();
+            changed.ParallelCopy_nowait(old_new, 0, 0, changed.nComp(),
+                                        IntVect{0}, IntVect{0}, geom.periodicity());
+        }
+
+        for (int li = 0; li < S_new.local_size(); ++li)
+        {
+            const int k = S_new.IndexArray()[li];
+            if (old_index[k] >= 0) {
+                S_new.setFab(k, std::unique_ptr<FArrayBox>(old_new.release(old_index[k])));
+            }
+        }
+    }
+}
+
+void
+AmrLevel::finishRegridFill ()
+{
+    BL_PROFILE("AmrLevel::finishRegridFill()");
+
+    for (int i = 0; i < desc_lst.size(); ++i)
+    {
+        MultiFab& S_new = *m_regrid_fill->new_data[i];
+        //
+        // If FABs are kept, only the other boxes are filled, and they are
+        // moved to S_new afterwards.
+        //
+        MultiFab* mf = m_regrid_fill->changed_data.empty()
+            ? &S_new : m_regrid_fill->changed_data[i].get();
+        if (mf == nullptr) continue;
+
+        const int ncomp = mf->nComp();
+        const Real time = state[i].curTime();
+
+        mf->ParallelCopy_finish();
+
+        if (level > 0)
+        {
+            Vector<FillPatchIterator::FillPiece> pieces;
+            for (auto const& r : desc_lst[i].sameInterps(0,ncomp)) {
+                pieces.push_back({i, r.first, r.first, r.second});
+            }
+            FillPatchIterator::FillFromCoarse(*mf, *this, time, 0, pieces);
+        }
+
+        StateDataPhysBCFunct physbcf(state[i],0,geom);
+        physbcf(*mf, 0, ncomp, IntVect{0}, time, 0);
+
+        set_preferred_boundary_values(*mf, i, 0, 0, ncomp, time);
+
+        if (mf != &S_new)
+        {
+            for (int li = 0; li < mf->local_size(); ++li)
+            {
+                const int k = mf->IndexArray()[li];
+                S_new.setFab(m_regrid_fill->changed_index[k],
+                             std::unique_ptr<FArrayBox>(mf->release(k)));
+            }
+            m_regrid_fill->changed_data[i].reset();
+        }
+    }
+}
+
 void
 AmrLevel::LevelDirectoryNames (const std::string &dir,
                                std::string &LevelDir,
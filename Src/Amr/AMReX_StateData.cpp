@@ -93,7 +93,8 @@ StateData::define (const Box&             p_domain,
                    const StateDescriptor& d,
                    Real                   time,
                    Real                   dt,
-                   const FabFactory<FArrayBox>& factory)
+                   const FabFactory<FArrayBox>& factory,
+                   std::unique_ptr<MultiFab> p_new_data)
 {
     BL_PROFILE("StateData::define()");
     domain = p_domain;
@@ -126,9 +127,19 @@ StateData::define (const Box&             p_domain,
     }
     int ncomp = desc->nComp();
 
-    new_data = std::make_unique<MultiFab>(grids,dmap,ncomp,desc->nExtra(),
-                                          MFInfo().SetTag("StateData").SetArena(arena),
-                                          *m_factory);
+    if (p_new_data)
+    {
+        BL_ASSERT(p_new_data->boxArray() == grids);
+        BL_ASSERT(p_new_data->DistributionMap() == dmap);
+        BL_ASSERT(p_new_data->nComp() == ncomp);
+        new_data = std::move(p_new_data);
+    }
+    else
+    {
+        new_data = std::make_unique<MultiFab>(grids,dmap,ncomp,desc->nExtra(),
+                                              MFInfo().SetTag("StateData").SetArena(arena),
+                                              *m_factory);
+    }
     old_data.reset();
 }
 
@@ -1,6 +1,8 @@
 
 #include <AMReX_AmrCore.H>
 #include <AMReX_Print.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_BLProfiler.H>
 
 #ifdef AMREX_PARTICLES
 #include <AMReX_AmrParGDB.H>
@@ -11,6 +13,7 @@
 #endif
 
 #include <algorithm>
+#include <limits>
 #include <ostream>
 
 namespace amrex {
@@ -86,7 +89,11 @@ AmrCore::regrid (int lbase, Real time, bool)
                 DistributionMapping level_dmap = dmap[lev];
                 if (ba_changed) {
                     level_grids = new_grids[lev];
-                    level_dmap = DistributionMapping(level_grids);
+                    if (use_incremental_regrid) {
+                        level_dmap = DistributionMapping::makeIncremental(level_grids, grids[lev], dmap[lev]);
+                    } else {
+                        level_dmap = DistributionMapping(level_grids);
+                    }
                 }
                 const auto old_num_setdm = num_setdm;
                 RemakeLevel(lev, time, level_grids, level_dmap);
@@ -119,6 +126,43 @@ AmrCore::regrid (int lbase, Real time, bool)
 }
 
 
+bool
+AmrCore::LoadBalance (int lev, Real time, const LayoutData<Real>& cost, Real threshold)
+{
+    BL_PROFILE("AmrCore::LoadBalance()");
+
+    AMREX_ALWAYS_ASSERT(lev <= finest_level && cost.DistributionMap() == dmap[lev]);
+
+    const int root = ParallelDescriptor::IOProcessorNumber();
+    Real currentEfficiency = 0.0_rt, proposedEfficiency = 0.0_rt;
+    DistributionMapping newdm =
+        (DistributionMapping::strategy() == DistributionMapping::KNAPSACK)
+        ? DistributionMapping::makeKnapSack(cost, currentEfficiency, proposedEfficiency,
+                                            std::numeric_limits<int>::max(), true, root)
+        : DistributionMapping::makeSFC(cost, currentEfficiency, proposedEfficiency, true, root);
+    ParallelDescriptor::Bcast(&currentEfficiency, 1, root);
+    ParallelDescriptor::Bcast(&proposedEfficiency, 1, root);
+
+    const bool rebalance = proposedEfficiency > (1.0_rt+threshold)*currentEfficiency;
+
+    if (verbose) {
+        amrex::Print() << "Load balance on level " << lev << " at t = " << time
+                       << ": current efficiency " << currentEfficiency
+                       << ", proposed " << proposedEfficiency
+                       << (rebalance ? ", redistributing\n" : ", keeping\n");
+    }
+
+    if (rebalance) {
+        const auto old_num_setdm = num_setdm;
+        RemakeLevel(lev, time, grids[lev], newdm);
+        if (old_num_setdm == num_setdm) {
+            SetDistributionMap(lev, newdm);
+        }
+    }
+
+    return rebalance;
+}
+
 void
 AmrCore::printGridSummary (std::ostream& os, int min_lev, int max_lev) const noexcept
 {
@@ -105,6 +105,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("n_proper",n_proper);
     pp.queryAdd("grid_eff",grid_eff);
+    pp.queryAdd("distributed_clustering",use_distributed_clustering);
+    pp.queryAdd("incremental_regrid",use_incremental_regrid);
     int cnt = pp.countval("n_error_buf");
     if (cnt > 0) {
         Vector<int> neb;
@@ -675,10 +677,18 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        Long numtags;
+        if (use_distributed_clustering) {
+            tags.local_collate(tagvec);
+            numtags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(numtags);
+        } else {
+            tags.collate(tagvec);
+            numtags = tagvec.size();
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        if (numtags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -689,23 +699,30 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
-                    BL_PROFILE("AmrMesh-cluster");
+                if (use_distributed_clustering) {
+                    BL_PROFILE("AmrMesh-cluster-distributed");
                     //
-                    // Construct initial cluster.
+                    // Every process clusters its own tags.  The clusters of
+                    // different processes may overlap, so the overlaps are
+                    // removed after all processes have gathered them.
                     //
-                    ClusterList clist(&tagvec[0], tagvec.size());
-                    if (use_new_chop) {
-                        clist.new_chop(grid_eff);
-                    } else {
-                        clist.chop(grid_eff);
+                    if (!tagvec.empty()) {
+                        ClusterList clist(tagvec.data(), tagvec.size());
+                        if (use_new_chop) {
+                            clist.new_chop(grid_eff);
+                        } else {
+                            clist.chop(grid_eff);
+                        }
+                        clist.intersect(p_n_ba[levc]);
+                        clist.boxList(new_bx);
+                    }
+                    tagvec.clear();
+                    amrex::AllGatherBoxes(new_bx.data());
+                    if (new_bx.size() > 1) {
+                        BoxArray cba(std::move(new_bx));
+                        cba.removeOverlap();
+                        new_bx = cba.boxList();
                     }
-                    clist.intersect(p_n_ba[levc]);
-                    //
-                    // Efficient properly nested Clusters have been constructed
-                    // now generate list of grids at level levf.
-                    //
-                    clist.boxList(new_bx);
                     new_bx.refine(bf_lev[levc]);
                     new_bx.simplify();
 
@@ -713,8 +730,34 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                         // Chop new grids outside domain
                         new_bx.intersect(Geom(levc).Domain());
                     }
+                } else {
+                    if (ParallelDescriptor::IOProcessor()) {
+                        BL_PROFILE("AmrMesh-cluster");
+                        //
+                        // Construct initial cluster.
+                        //
+                        ClusterList clist(&tagvec[0], tagvec.size());
+                        if (use_new_chop) {
+                            clist.new_chop(grid_eff);
+                        } else {
+                            clist.chop(grid_eff);
+                        }
+                        clist.intersect(p_n_ba[levc]);
+                        //
+                        // Efficient properly nested Clusters have been constructed
+                        // now generate list of grids at level levf.
+                        //
+                        clist.boxList(new_bx);
+                        new_bx.refine(bf_lev[levc]);
+                        new_bx.simplify();
+
+                        if (new_bx.size()>0) {
+                            // Chop new grids outside domain
+                            new_bx.intersect(Geom(levc).Domain());
+                        }
+                    }
+                    new_bx.Bcast();  // Broadcast the new BoxList to other processes
                 }
-                new_bx.Bcast();  // Broadcast the new BoxList to other processes
 
                 //
                 // Refine up to levf.
@@ -1038,6 +1081,8 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
+    os << "  use_distributed_clustering = " << amr_mesh.use_distributed_clustering << "\n";
+    os << "  use_incremental_regrid = " << amr_mesh.use_incremental_regrid << "\n";
     return os;
 }
 
@@ -43,6 +43,11 @@ namespace {
     Long the_managed_arena_release_threshold = std::numeric_limits<Long>::max();
     Long the_pinned_arena_release_threshold = std::numeric_limits<Long>::max();
     Long the_async_arena_release_threshold = std::numeric_limits<Long>::max();
+    // Blocks freed from GPU stream callbacks would be stranded in the
+    // callback thread's cache, and CPU builds use BArena unless asked,
+    // so size classes are opt-in.
+    Long the_arena_size_class_max = 0L;
+    Long the_arena_thread_cache_size = 1024*1024*8;
 #ifdef AMREX_USE_HIP
     bool the_arena_is_managed = false; // xxxxx HIP FIX HERE
 #else
@@ -262,13 +267,16 @@ Arena::Initialize ()
     pp.queryAdd("the_managed_arena_release_threshold", the_managed_arena_release_threshold);
     pp.queryAdd( "the_pinned_arena_release_threshold",  the_pinned_arena_release_threshold);
     pp.queryAdd(  "the_async_arena_release_threshold",   the_async_arena_release_threshold);
+    pp.queryAdd(       "the_arena_size_class_max",          the_arena_size_class_max);
+    pp.queryAdd(       "the_arena_thread_cache_size",       the_arena_thread_cache_size);
     pp.queryAdd("the_arena_is_managed", the_arena_is_managed);
     pp.queryAdd("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
 
     {
 #if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
         ArenaInfo ai{};
-        ai.SetReleaseThreshold(the_arena_release_threshold);
+        ai.SetReleaseThreshold(the_arena_release_threshold)
+          .SetSizeClasses(the_arena_size_class_max, the_arena_thread_cache_size);
         if (the_arena_is_managed) {
             the_arena = new CArena(0, ai.SetPreferred());
         } else {
@@ -279,7 +287,14 @@ Arena::Initialize ()
         the_arena->free(p);
 #endif
 #else
-        the_arena = The_BArena();
+        if (the_arena_size_class_max > 0) {
+            ArenaInfo ai{};
+            ai.SetReleaseThreshold(the_arena_release_threshold)
+              .SetSizeClasses(the_arena_size_class_max, the_arena_thread_cache_size);
+            the_arena = new CArena(0, ai);
+        } else {
+            the_arena = The_BArena();
+        }
 #endif
     }
 
@@ -4,12 +4,84 @@
 #include <AMReX_Gpu.H>
 #include <AMReX_ParallelReduce.H>
 
+#include <algorithm>
+#include <unordered_map>
 #include <utility>
 #include <cstring>
 
 namespace amrex {
 
+//! The free size-class blocks a thread holds for one CArena.
+struct CArena::ThreadCache
+{
+    ThreadCache () = default;
+    ThreadCache (const ThreadCache&) = delete;
+    ThreadCache& operator= (const ThreadCache&) = delete;
+    //! Hands the cached blocks to the shared lists when the thread exits.
+    ~ThreadCache ();
+
+    std::uint64_t arena_id = 0;
+    Long epoch = -1;
+    //! The size class of every block this thread has handed out or freed.
+    std::unordered_map<void*,int> known;
+    std::vector<std::vector<void*> > bins;
+    std::size_t bytes = 0;
+    SizeClassCounters* counters = nullptr;
+};
+
+namespace {
+
+    std::atomic<std::uint64_t> carena_next_id{0};
+
+    //
+    // The live CArenas with size classes, so that an exiting thread can
+    // tell whether the arena of one of its caches still exists.
+    //
+    std::mutex& carena_registry_mutex ()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    std::unordered_map<std::uint64_t,CArena*>& carena_registry ()
+    {
+        static std::unordered_map<std::uint64_t,CArena*> r;
+        return r;
+    }
+
+    //
+    // Size classes are multiples of 16 bytes up to 128 bytes and then four
+    // classes per power of two, so that rounding up wastes at most 25%.
+    //
+    int sizeClass (std::size_t nbytes) noexcept
+    {
+        if (nbytes <= 128) {
+            return static_cast<int>((nbytes+15)/16) - 1;
+        }
+        int lg = 0;
+        for (std::size_t n = (nbytes-1) >> 1; n > 0; n >>= 1) { ++lg; }
+        const std::size_t p = std::size_t(1) << lg;
+        return 8 + (lg-7)*4 + static_cast<int>((nbytes-p-1)/(p/4));
+    }
+
+    std::size_t classSize (int c) noexcept
+    {
+        if (c < 8) {
+            return 16*(c+1);
+        }
+        const std::size_t p = std::size_t(1) << ((c-8)/4 + 7);
+        return p + ((c-8)%4 + 1)*(p/4);
+    }
+
+    // The owning thread is the only writer, so no atomic read-modify-write is needed.
+    void bump (std::atomic<Long>& counter, Long n = 1) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+}
+
 CArena::CArena (std::size_t hunk_size, ArenaInfo info)
+    : m_id(carena_next_id.fetch_add(1))
 {
     arena_info = info;
     //
@@ -21,10 +93,23 @@ CArena::CArena (std::size_t hunk_size, ArenaInfo info)
 
     BL_ASSERT(m_hunk >= hunk_size);
     BL_ASSERT(m_hunk%Arena::align_size == 0);
+
+    if (info.size_class_max > 0) {
+        m_nclasses = sizeClass(Arena::align(info.size_class_max)) + 1;
+        m_class_max = classSize(m_nclasses-1);
+        m_cache_max = static_cast<std::size_t>(std::max(info.thread_cache_size, Long(0)));
+        m_depot.resize(m_nclasses);
+        std::lock_guard<std::mutex> lock(carena_registry_mutex());
+        carena_registry()[m_id] = this;
+    }
 }
 
 CArena::~CArena ()
 {
+    if (m_class_max > 0) {
+        std::lock_guard<std::mutex> lock(carena_registry_mutex());
+        carena_registry().erase(m_id);
+    }
     for (unsigned int i = 0, N = m_alloc.size(); i < N; i++) {
         deallocate_system(m_alloc[i].first, m_alloc[i].second);
     }
@@ -33,11 +118,21 @@ CArena::~CArena ()
 void*
 CArena::alloc (std::size_t nbytes)
 {
-    std::lock_guard<std::mutex> lock(carena_mutex);
-
     nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
 
+    if (nbytes <= m_class_max) {
+        return allocSizeClass(nbytes);
+    }
+
+    std::lock_guard<std::mutex> lock(carena_mutex);
+    return alloc_protected(nbytes);
+}
+
+void*
+CArena::alloc_protected (std::size_t nbytes)
+{
     if (static_cast<Long>(m_used+nbytes) >= arena_info.release_threshold) {
+        releaseSizeClasses_protected(nullptr);
         freeUnused_protected();
     }
 
@@ -122,7 +217,17 @@ CArena::free (void* vp)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(carena_mutex);
+    ThreadCache* tc = nullptr;
+    if (m_class_max > 0) {
+        tc = &threadCache();
+        auto it = tc->known.find(vp);
+        if (it != tc->known.end()) {
+            freeSizeClass(*tc, vp, it->second);
+            return;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(carena_mutex);
 
     //
     // `vp' had better be in the busy list.
@@ -132,6 +237,25 @@ CArena::free (void* vp)
         amrex::Abort("CArena::free: unknown pointer");
         return;
     }
+
+    if (busy_it->size() <= m_class_max) {
+        //
+        // A size-class block handed out by another thread.
+        //
+        const int c = sizeClass(busy_it->size());
+        lock.unlock();
+        tc->known.emplace(vp, c);
+        bump(tc->counters->nremote);
+        freeSizeClass(*tc, vp, c);
+        return;
+    }
+
+    free_protected(busy_it);
+}
+
+void
+CArena::free_protected (std::unordered_set<Node, Node::hash>::iterator busy_it)
+{
     BL_ASSERT(m_freelist.find(*busy_it) == m_freelist.end());
 
     m_actually_used -= busy_it->size();
@@ -198,10 +322,178 @@ CArena::free (void* vp)
     }
 }
 
+void*
+CArena::allocSizeClass (std::size_t nbytes)
+{
+    ThreadCache& tc = threadCache();
+    const int c = sizeClass(nbytes);
+    auto& bin = tc.bins[c];
+    bump(tc.counters->nalloc);
+    if (bin.empty()) {
+        refill(tc, c);
+    } else {
+        bump(tc.counters->nhit);
+    }
+    void* vp = bin.back();
+    bin.pop_back();
+    const std::size_t sz = classSize(c);
+    tc.bytes -= sz;
+    bump(tc.counters->cached_bytes, -static_cast<Long>(sz));
+    return vp;
+}
+
+void
+CArena::freeSizeClass (ThreadCache& tc, void* vp, int c)
+{
+    const std::size_t sz = classSize(c);
+    tc.bins[c].push_back(vp);
+    tc.bytes += sz;
+    bump(tc.counters->nfree);
+    bump(tc.counters->cached_bytes, static_cast<Long>(sz));
+    if (tc.bytes > m_cache_max) {
+        spill(tc);
+    }
+}
+
+CArena::ThreadCache&
+CArena::threadCache ()
+{
+    // Caches of dead arenas are never looked up again since ids are not reused.
+    thread_local std::unordered_map<std::uint64_t,ThreadCache> thread_caches;
+
+    ThreadCache& tc = thread_caches[m_id];
+    if (tc.counters == nullptr) {
+        std::lock_guard<std::mutex> lock(carena_mutex);
+        m_counters.emplace_back(new SizeClassCounters);
+        tc.counters = m_counters.back().get();
+        tc.bins.resize(m_nclasses);
+        tc.arena_id = m_id;
+    }
+    const Long epoch = m_epoch.load(std::memory_order_acquire);
+    if (tc.epoch != epoch) {
+        //
+        // Some size-class blocks went back to the free list and their
+        // addresses may have been handed out again with other sizes.
+        //
+        tc.known.clear();
+        tc.epoch = epoch;
+    }
+    return tc;
+}
+
+void
+CArena::refill (ThreadCache& tc, int c)
+{
+    const std::size_t sz = classSize(c);
+    auto& bin = tc.bins[c];
+
+    std::lock_guard<std::mutex> lock(carena_mutex);
+
+    bump(tc.counters->nrefill);
+
+    auto& depot = m_depot[c];
+    if (depot.empty()) {
+        //
+        // Carve a batch of blocks out of one chunk, but register each as a
+        // busy block of its own so that they can go back individually.
+        //
+        const std::size_t nblocks = std::max(std::size_t(1),
+                                             std::min(std::size_t(32), std::size_t(64*1024)/sz));
+        auto p = static_cast<char*>(alloc_protected(nblocks*sz));
+        auto busy_it = m_busylist.find(Node(p,0,0));
+        void* owner = busy_it->owner();
+        m_busylist.erase(busy_it);
+        for (std::size_t i = 0; i < nblocks; ++i) {
+            m_busylist.insert(Node(p+i*sz, owner, sz));
+            depot.push_back(p+(nblocks-1-i)*sz);
+        }
+        bump(tc.counters->ncarve);
+    }
+
+    // Take half of what is there, but at least one block.
+    const std::size_t n = std::max(depot.size()/2, std::min(depot.size(), std::size_t(32)));
+    for (auto it = depot.end()-n; it != depot.end(); ++it) {
+        bin.push_back(*it);
+        tc.known.emplace(*it, c);
+    }
+    depot.erase(depot.end()-n, depot.end());
+
+    tc.bytes += n*sz;
+    bump(tc.counters->cached_bytes, static_cast<Long>(n*sz));
+}
+
+void
+CArena::spill (ThreadCache& tc)
+{
+    std::lock_guard<std::mutex> lock(carena_mutex);
+
+    bump(tc.counters->nspill);
+
+    for (int c = 0; c < m_nclasses; ++c) {
+        auto& bin = tc.bins[c];
+        const std::size_t n = (bin.size()+1)/2;
+        m_depot[c].insert(m_depot[c].end(), bin.begin(), bin.begin()+n);
+        bin.erase(bin.begin(), bin.begin()+n);
+        tc.bytes -= n*classSize(c);
+        bump(tc.counters->cached_bytes, -static_cast<Long>(n*classSize(c)));
+    }
+}
+
+CArena::ThreadCache::~ThreadCache ()
+{
+    if (counters == nullptr) { return; }
+    std::lock_guard<std::mutex> rlock(carena_registry_mutex());
+    auto it = carena_registry().find(arena_id);
+    if (it != carena_registry().end()) {
+        CArena* arena = it->second;
+        std::lock_guard<std::mutex> lock(arena->carena_mutex);
+        arena->returnThreadCache_protected(*this);
+    }
+}
+
+void
+CArena::returnThreadCache_protected (ThreadCache& tc)
+{
+    for (int c = 0; c < m_nclasses; ++c) {
+        auto& bin = tc.bins[c];
+        m_depot[c].insert(m_depot[c].end(), bin.begin(), bin.end());
+        bin.clear();
+    }
+    bump(tc.counters->cached_bytes, -static_cast<Long>(tc.bytes));
+    tc.bytes = 0;
+}
+
+void
+CArena::releaseSizeClasses_protected (ThreadCache* tc)
+{
+    if (tc) {
+        returnThreadCache_protected(*tc);
+    }
+
+    bool released = false;
+    for (auto& depot : m_depot) {
+        for (void* vp : depot) {
+            free_protected(m_busylist.find(Node(vp,0,0)));
+        }
+        released = released || !depot.empty();
+        depot.clear();
+    }
+
+    if (released) {
+        m_epoch.fetch_add(1, std::memory_order_release);
+    }
+}
+
 std::size_t
 CArena::freeUnused ()
 {
+    //
+    // Only the calling thread's cache can be returned.  Blocks cached by
+    // other threads stay with their size class.
+    //
+    ThreadCache* tc = (m_class_max > 0) ? &threadCache() : nullptr;
     std::lock_guard<std::mutex> lock(carena_mutex);
+    releaseSizeClasses_protected(tc);
     return freeUnused_protected();
 }
 
@@ -279,6 +571,32 @@ CArena::PrintUsage (std::string const& name) const
     amrex::Print() << "[" << name << "] space allocated (MB): " << min_megabytes << "\n";
     amrex::Print() << "[" << name << "] space used      (MB): " << actual_min_megabytes << "\n";
 #endif
+    if (m_class_max > 0) {
+        auto const& st = sizeClassStats();
+        Long nalloc = st.nalloc;
+        Long nhit = st.nhit;
+        ParallelReduce::Sum<Long>({nalloc, nhit}, IOProc, ParallelDescriptor::Communicator());
+        amrex::Print() << "[" << name << "] size-class allocs: " << nalloc
+                       << ", thread cache hits: " << nhit << "\n";
+    }
+}
+
+CArena::SizeClassStats
+CArena::sizeClassStats () const
+{
+    SizeClassStats r;
+    std::lock_guard<std::mutex> lock(carena_mutex);
+    for (auto const& c : m_counters) {
+        r.nalloc       += c->nalloc.load(std::memory_order_relaxed);
+        r.nhit         += c->nhit.load(std::memory_order_relaxed);
+        r.nfree        += c->nfree.load(std::memory_order_relaxed);
+        r.nremote      += c->nremote.load(std::memory_order_relaxed);
+        r.nrefill      += c->nrefill.load(std::memory_order_relaxed);
+        r.ncarve       += c->ncarve.load(std::memory_order_relaxed);
+        r.nspill       += c->nspill.load(std::memory_order_relaxed);
+        r.cached_bytes += c->cached_bytes.load(std::memory_order_relaxed);
+    }
+    return r;
 }
 
 void
@@ -290,6 +608,13 @@ CArena::PrintUsage (std::ostream& os, std::string const& name, std::string const
     os << space << "[" << name << "] space used      (MB): " << actual_megabytes << "\n";
     os << space << "[" << name << "]: " << m_alloc.size() << " allocs, "
        << m_busylist.size() << " busy blocks, " << m_freelist.size() << " free blocks\n";
+    if (m_class_max > 0) {
+        auto const& st = sizeClassStats();
+        os << space << "[" << name << "] size classes: " << st.nalloc << " allocs, "
+           << st.nhit << " cache hits, " << st.nremote << " remote frees, "
+           << st.nrefill << " refills, " << st.ncarve << " carves, " << st.nspill << " spills, "
+           << st.cached_bytes/(1024*1024) << " MB cached\n";
+    }
 }
 
 }
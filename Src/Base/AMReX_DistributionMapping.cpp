@@ -9,12 +9,14 @@
 #include <AMReX_VisMF.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Morton.H>
+#include <AMReX_Machine.H>
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
 #include <map>
+#include <set>
 #include <vector>
 #include <queue>
 #include <algorithm>
@@ -37,6 +39,9 @@ namespace amrex {
     int    sfc_threshold;
     Real   max_efficiency;
     int    node_size;
+    int    graph_ngrow;
+    Real   graph_imbalance;
+    int    topology_aware;
 
 // We default to SFC.
 DistributionMapping::Strategy DistributionMapping::m_Strategy = DistributionMapping::SFC;
@@ -74,6 +79,12 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case HILBERT:
+        m_BuildMap = &DistributionMapping::HilbertProcessorMap;
+        break;
+    case GRAPH:
+        m_BuildMap = &DistributionMapping::GraphProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -91,6 +102,30 @@ DistributionMapping::SFC_Threshold ()
     return sfc_threshold;
 }
 
+void
+DistributionMapping::TopologyAware (bool flag)
+{
+    topology_aware = flag;
+}
+
+bool
+DistributionMapping::TopologyAware ()
+{
+    return topology_aware;
+}
+
+void
+DistributionMapping::NodeSize (int n)
+{
+    node_size = std::max(n,0);
+}
+
+int
+DistributionMapping::NodeSize ()
+{
+    return node_size;
+}
+
 bool
 DistributionMapping::operator== (const DistributionMapping& rhs) const noexcept
 {
@@ -114,6 +149,9 @@ DistributionMapping::Initialize ()
     sfc_threshold    = 0;
     max_efficiency   = 0.9_rt;
     node_size        = 0;
+    graph_ngrow      = 1;
+    graph_imbalance  = 0.05_rt;
+    topology_aware   = 0;
     flag_verbose_mapper = 0;
 
     ParmParse pp("DistributionMapping");
@@ -124,6 +162,9 @@ DistributionMapping::Initialize ()
     pp.queryAdd("sfc_threshold",       sfc_threshold);
     pp.queryAdd("node_size",           node_size);
     pp.queryAdd("verbose_mapper",      flag_verbose_mapper);
+    pp.queryAdd("graph_ngrow",         graph_ngrow);
+    pp.queryAdd("graph_imbalance",     graph_imbalance);
+    pp.queryAdd("topology_aware",      topology_aware);
 
     std::string theStrategy;
 
@@ -145,6 +186,14 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "HILBERT")
+        {
+            strategy(HILBERT);
+        }
+        else if (theStrategy == "GRAPH")
+        {
+            strategy(GRAPH);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -344,6 +393,18 @@ DistributionMapping::define (const BoxArray& boxes,
 
     BL_ASSERT(m_BuildMap != 0);
 
+    if (topology_aware && m_Strategy != ROUNDROBIN && m_Strategy != RRSFC)
+    {
+        std::vector<Long> wgts;
+        wgts.reserve(boxes.size());
+        for (int i = 0, N = boxes.size(); i < N; ++i) {
+            wgts.push_back(boxes[i].volume());
+        }
+        if (TopologyAwareDoIt(boxes, wgts, nprocs, m_Strategy == KNAPSACK)) {
+            return;
+        }
+    }
+
     (this->*m_BuildMap)(boxes,nprocs);
 }
 
@@ -995,6 +1056,195 @@ namespace {
 
         return token;
     }
+
+    //
+    // Node of each process in the current ParallelContext, numbered from
+    // zero in order of the lowest process on it.  node_size > 0 imposes
+    // nodes of that many consecutive processes.
+    //
+    std::vector<int> nodeOfProc (int nprocs)
+    {
+        std::vector<int> r(nprocs, 0);
+        if (node_size > 0) {
+            for (int i = 0; i < nprocs; ++i) {
+                r[i] = i / node_size;
+            }
+        } else {
+#ifdef BL_USE_MPI
+            const Vector<int>& node_of_rank = machine::shared_memory_node_ids();
+            std::map<int,int> node_index;
+            for (int i = 0; i < nprocs; ++i) {
+                const int node = node_of_rank[ParallelContext::local_to_global_rank(i)];
+                r[i] = node_index.emplace(node, static_cast<int>(node_index.size())).first->second;
+            }
+#endif
+        }
+        return r;
+    }
+
+    //
+    // Position along a Hilbert curve of the point x with nbits bits per
+    // direction, using Skilling's transpose algorithm (AIP Conf. Proc. 707,
+    // 381 (2004)).
+    //
+    uint64_t hilbertKey (Array<uint32_t,AMREX_SPACEDIM> x, int nbits)
+    {
+        constexpr int n = AMREX_SPACEDIM;
+        const uint32_t M = 1u << (nbits-1);
+        // Inverse undo
+        for (uint32_t Q = M; Q > 1; Q >>= 1) {
+            const uint32_t P = Q - 1;
+            for (int i = 0; i < n; ++i) {
+                if (x[i] & Q) {
+                    x[0] ^= P;
+                } else {
+                    const uint32_t t = (x[0] ^ x[i]) & P;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                }
+            }
+        }
+        // Gray encode
+        for (int i = 1; i < n; ++i) {
+            x[i] ^= x[i-1];
+        }
+        uint32_t t = 0;
+        for (uint32_t Q = M; Q > 1; Q >>= 1) {
+            if (x[n-1] & Q) { t ^= Q-1; }
+        }
+        for (int i = 0; i < n; ++i) {
+            x[i] ^= t;
+        }
+        // Interleave the transposed bits
+        uint64_t key = 0;
+        for (int b = nbits-1; b >= 0; --b) {
+            for (int i = 0; i < n; ++i) {
+                key = (key << 1) | ((x[i] >> b) & 1u);
+            }
+        }
+        return key;
+    }
+
+    //! Sort the tokens along a Hilbert curve through the small ends of the boxes.
+    void hilbertSort (std::vector<SFCToken>& tokens, const BoxArray& boxes)
+    {
+        constexpr int nbits = (AMREX_SPACEDIM == 1) ? 32 : 63/AMREX_SPACEDIM;
+        const Box bbox = boxes.minimalBox();
+        const IntVect lo = bbox.smallEnd();
+        // Coarsen so that the extent fits into nbits bits.
+        int shift = 0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            while ((static_cast<uint64_t>(bbox.length(idim)) >> shift) >= (uint64_t(1) << nbits)) {
+                ++shift;
+            }
+        }
+        const int N = static_cast<int>(tokens.size());
+        std::vector<std::pair<uint64_t,int> > keys;
+        keys.reserve(N);
+        for (int i = 0; i < N; ++i) {
+            const Box& bx = boxes[tokens[i].m_box];
+            Array<uint32_t,AMREX_SPACEDIM> x;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                x[idim] = static_cast<uint32_t>(bx.smallEnd(idim)-lo[idim]) >> shift;
+            }
+            keys.emplace_back(hilbertKey(x,nbits), i);
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<SFCToken> sorted;
+        sorted.reserve(N);
+        for (auto const& k : keys) {
+            sorted.push_back(tokens[k.second]);
+        }
+        std::swap(tokens, sorted);
+    }
+
+    //
+    // Weighted adjacency of boxes.  The weight of an edge is the number of
+    // ghost cells the two boxes fill for each other.
+    //
+    struct BoxGraph
+    {
+        std::vector<int>  start; // edges of box i are [start[i],start[i+1])
+        std::vector<int>  nbr;
+        std::vector<Long> wgt;
+    };
+
+    BoxGraph makeBoxGraph (const BoxArray& boxes, const IntVect& ngrow)
+    {
+        const int N = boxes.size();
+        std::vector<std::map<int,Long> > adj(N);
+        std::vector<std::pair<int,Box> > isects;
+        for (int i = 0; i < N; ++i) {
+            boxes.intersections(amrex::grow(boxes[i],ngrow), isects);
+            for (auto const& is : isects) {
+                if (is.first != i) {
+                    const Long v = is.second.numPts();
+                    adj[i][is.first] += v;
+                    adj[is.first][i] += v;
+                }
+            }
+        }
+        BoxGraph g;
+        g.start.resize(N+1);
+        g.start[0] = 0;
+        for (int i = 0; i < N; ++i) {
+            g.start[i+1] = g.start[i] + static_cast<int>(adj[i].size());
+            for (auto const& kv : adj[i]) {
+                g.nbr.push_back(kv.first);
+                g.wgt.push_back(kv.second);
+            }
+        }
+        return g;
+    }
+
+    //
+    // Greedy boundary refinement: move a box to the partition it shares
+    // the most ghost cells with as long as that reduces the edge cut and
+    // keeps the load of the target within maxload.
+    //
+    void refinePartition (const BoxGraph& g, const std::vector<Long>& wgts,
+                          std::vector<int>& part, int nparts, const std::vector<Real>& maxload)
+    {
+        const int N = static_cast<int>(part.size());
+        std::vector<Real> load(nparts, 0);
+        std::vector<int> count(nparts, 0);
+        for (int i = 0; i < N; ++i) {
+            load[part[i]] += wgts[i];
+            ++count[part[i]];
+        }
+
+        std::map<int,Long> conn;
+        for (int pass = 0; pass < 8; ++pass) {
+            int nmoves = 0;
+            for (int i = 0; i < N; ++i) {
+                const int p = part[i];
+                if (count[p] == 1) { continue; }
+                conn.clear();
+                for (int e = g.start[i]; e < g.start[i+1]; ++e) {
+                    conn[part[g.nbr[e]]] += g.wgt[e];
+                }
+                const Long internal = conn.count(p) ? conn[p] : 0;
+                int  best = p;
+                Long best_gain = 0;
+                for (auto const& kv : conn) {
+                    const Long gain = kv.second - internal;
+                    if (kv.first != p && gain > best_gain && load[kv.first] + wgts[i] <= maxload[kv.first]) {
+                        best = kv.first;
+                        best_gain = gain;
+                    }
+                }
+                if (best != p) {
+                    part[i] = best;
+                    load[p] -= wgts[i];
+                    load[best] += wgts[i];
+                    --count[p];
+                    ++count[best];
+                    ++nmoves;
+                }
+            }
+            if (nmoves == 0) { break; }
+        }
+    }
 }
 
 static
@@ -1086,7 +1336,8 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
                                           const std::vector<Long>& wgts,
                                           int                   /*   nprocs */,
                                           bool                     sort,
-                                          Real*                    eff)
+                                          Real*                    eff,
+                                          bool                     hilbert)
 {
     if (flag_verbose_mapper) {
         Print() << "DM: SFCProcessorMapDoIt called..." << std::endl;
@@ -1126,9 +1377,13 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
         tokens.push_back(makeSFCToken(i, bx.smallEnd()));
     }
     //
-    // Put'm in Morton space filling curve order.
+    // Put'm in Morton or Hilbert space filling curve order.
     //
-    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    if (hilbert) {
+        hilbertSort(tokens, boxes);
+    } else {
+        std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    }
     //
     // Split'm up as equitably as possible per team.
     //
@@ -1274,7 +1529,7 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
 
         if (verbose)
         {
-            amrex::Print() << "SFC efficiency: " << efficiency << '\n';
+            amrex::Print() << (hilbert ? "HILBERT" : "SFC") << " efficiency: " << efficiency << '\n';
         }
     }
 }
@@ -1323,7 +1578,7 @@ DistributionMapping::SFCProcessorMap (const BoxArray&          boxes,
     {
         KnapSackProcessorMap(wgts,nprocs);
     }
-    else
+    else if (!(topology_aware && TopologyAwareDoIt(boxes,wgts,nprocs,false)))
     {
         SFCProcessorMapDoIt(boxes,wgts,nprocs,sort);
     }
@@ -1346,7 +1601,7 @@ DistributionMapping::SFCProcessorMap (const BoxArray&          boxes,
     {
         KnapSackProcessorMap(wgts,nprocs,&eff);
     }
-    else
+    else if (!(topology_aware && TopologyAwareDoIt(boxes,wgts,nprocs,false,&eff)))
     {
         SFCProcessorMapDoIt(boxes,wgts,nprocs,sort,&eff);
     }
@@ -1397,6 +1652,382 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+void
+DistributionMapping::HilbertProcessorMap (const BoxArray& boxes,
+                                          int             nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(boxes.size());
+
+    if (boxes.size() < sfc_threshold*nprocs)
+    {
+        KnapSackProcessorMap(boxes,nprocs);
+    }
+    else
+    {
+        std::vector<Long> wgts;
+
+        wgts.reserve(boxes.size());
+
+        for (int i = 0, N = boxes.size(); i < N; ++i)
+        {
+            wgts.push_back(boxes[i].volume());
+        }
+
+        SFCProcessorMapDoIt(boxes,wgts,nprocs,true,nullptr,true);
+    }
+}
+
+void
+DistributionMapping::AssignBins (const std::vector<std::vector<int> >& vec,
+                                 const std::vector<Long>& wgts, int nprocs)
+{
+    std::vector<LIpair> LIpairV;
+    LIpairV.reserve(nprocs);
+    for (int i = 0; i < nprocs; ++i)
+    {
+        Long wgt = 0;
+        for (int ibox : vec[i]) {
+            wgt += wgts[ibox];
+        }
+        LIpairV.push_back(LIpair(wgt,i));
+    }
+
+    Sort(LIpairV, true);
+
+    Vector<int> ord;
+    LeastUsedCPUs(nprocs,ord);
+
+    for (int i = 0; i < nprocs; ++i)
+    {
+        const int rank = ParallelContext::local_to_global_rank(ord[i]);
+        for (int ibox : vec[LIpairV[i].second]) {
+            m_ref->m_pmap[ibox] = rank;
+        }
+    }
+}
+
+void
+DistributionMapping::GraphDoIt (const BoxArray&          boxes,
+                                const std::vector<Long>& wgts,
+                                int                      nprocs)
+{
+    BL_PROFILE("DistributionMapping::GraphDoIt()");
+
+#if defined (BL_USE_TEAM)
+    amrex::Abort("Team support is not implemented yet in GRAPH");
+#endif
+
+    const int N = boxes.size();
+    std::vector<SFCToken> tokens;
+    tokens.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = boxes[i];
+        tokens.push_back(makeSFCToken(i, bx.smallEnd()));
+    }
+    hilbertSort(tokens, boxes);
+
+    Real volperproc = 0;
+    for (Long wt : wgts) {
+        volperproc += wt;
+    }
+    volperproc /= nprocs;
+
+    std::vector< std::vector<int> > vec(nprocs);
+    Distribute(tokens,wgts,nprocs,volperproc,vec);
+
+    std::vector<int> part(N);
+    Real maxload = 0;
+    for (int p = 0; p < nprocs; ++p) {
+        Real load = 0;
+        for (int ibox : vec[p]) {
+            part[ibox] = p;
+            load += wgts[ibox];
+        }
+        maxload = std::max(maxload, load);
+    }
+    maxload = std::max(maxload, volperproc*(1.0_rt+graph_imbalance));
+
+    const BoxGraph& g = makeBoxGraph(boxes, IntVect(graph_ngrow));
+    refinePartition(g, wgts, part, nprocs, std::vector<Real>(nprocs, maxload));
+
+    for (auto& v : vec) {
+        v.clear();
+    }
+    for (int i = 0; i < N; ++i) {
+        vec[part[i]].push_back(i);
+    }
+
+    AssignBins(vec, wgts, nprocs);
+
+    if (verbose)
+    {
+        Real sum_wgt = 0, max_wgt = 0;
+        for (auto const& v : vec) {
+            Real W = 0;
+            for (int ibox : v) {
+                W += wgts[ibox];
+            }
+            max_wgt = std::max(max_wgt, W);
+            sum_wgt += W;
+        }
+        amrex::Print() << "GRAPH efficiency: " << sum_wgt/(nprocs*max_wgt) << '\n';
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray& boxes,
+                                        int             nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(boxes.size());
+
+    if (boxes.size() < sfc_threshold*nprocs || boxes.size() < nprocs)
+    {
+        KnapSackProcessorMap(boxes,nprocs);
+    }
+    else
+    {
+        std::vector<Long> wgts;
+
+        wgts.reserve(boxes.size());
+
+        for (int i = 0, N = boxes.size(); i < N; ++i)
+        {
+            wgts.push_back(boxes[i].volume());
+        }
+
+        GraphDoIt(boxes,wgts,nprocs);
+    }
+}
+
+bool
+DistributionMapping::TopologyAwareDoIt (const BoxArray&          boxes,
+                                        const std::vector<Long>& wgts,
+                                        int                      nprocs,
+                                        bool                     knapsack_in_node,
+                                        Real*                    eff)
+{
+    std::vector<std::vector<int> > node_procs;
+    {
+        const std::vector<int>& node_of_proc = nodeOfProc(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            if (node_of_proc[i] >= static_cast<int>(node_procs.size())) {
+                node_procs.resize(node_of_proc[i]+1);
+            }
+            node_procs[node_of_proc[i]].push_back(i);
+        }
+    }
+
+    const int nnodes = node_procs.size();
+    const int N = boxes.size();
+    if (nnodes <= 1 || nnodes == nprocs || N < nprocs) {
+        return false;
+    }
+
+    BL_PROFILE("DistributionMapping::TopologyAwareDoIt()");
+
+    std::vector<SFCToken> tokens;
+    tokens.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = boxes[i];
+        tokens.push_back(makeSFCToken(i, bx.smallEnd()));
+    }
+    hilbertSort(tokens, boxes);
+
+    Real totalvol = 0;
+    for (Long wt : wgts) {
+        totalvol += wt;
+    }
+
+    //
+    // Split the curve across nodes in proportion to their process counts.
+    //
+    std::vector<Real> target(nnodes);
+    for (int n = 0; n < nnodes; ++n) {
+        target[n] = totalvol * node_procs[n].size() / nprocs;
+    }
+
+    std::vector<int> part(N);
+    {
+        int n = 0;
+        Real cum = 0, bound = target[0];
+        for (auto const& t : tokens) {
+            const Real w = wgts[t.m_box];
+            if (cum + 0.5_rt*w > bound && n < nnodes-1) {
+                bound += target[++n];
+            }
+            part[t.m_box] = n;
+            cum += w;
+        }
+    }
+
+    std::vector<Real> maxload(nnodes);
+    {
+        std::vector<Real> load(nnodes, 0);
+        for (int i = 0; i < N; ++i) {
+            load[part[i]] += wgts[i];
+        }
+        for (int n = 0; n < nnodes; ++n) {
+            maxload[n] = std::max(load[n], target[n]*(1.0_rt+graph_imbalance));
+        }
+    }
+
+    const BoxGraph& g = makeBoxGraph(boxes, IntVect(graph_ngrow));
+    refinePartition(g, wgts, part, nnodes, maxload);
+
+    //
+    // Distribute the boxes of each node over its processes.
+    //
+    std::vector<Real> procvol(nprocs, 0);
+    for (int n = 0; n < nnodes; ++n)
+    {
+        const std::vector<int>& procs = node_procs[n];
+        const int nworkers = procs.size();
+
+        std::vector<SFCToken> node_tokens;
+        for (auto const& t : tokens) {
+            if (part[t.m_box] == n) { node_tokens.push_back(t); }
+        }
+
+        std::vector<std::vector<int> > vec(nworkers);
+        if (knapsack_in_node)
+        {
+            std::vector<Long> local_wgts;
+            for (auto const& t : node_tokens) {
+                local_wgts.push_back(wgts[t.m_box]);
+            }
+            std::vector<std::vector<int> > kpres;
+            Real kpeff;
+            knapsack(local_wgts, nworkers, kpres, kpeff, true, N);
+            for (int w = 0; w < nworkers; ++w) {
+                for (int j : kpres[w]) {
+                    vec[w].push_back(node_tokens[j].m_box);
+                }
+            }
+        }
+        else
+        {
+            Real nodevol = 0;
+            for (auto const& t : node_tokens) {
+                nodevol += wgts[t.m_box];
+            }
+            Distribute(node_tokens, wgts, nworkers, nodevol/nworkers, vec);
+        }
+
+        for (int w = 0; w < nworkers; ++w) {
+            const int rank = ParallelContext::local_to_global_rank(procs[w]);
+            for (int ibox : vec[w]) {
+                m_ref->m_pmap[ibox] = rank;
+                procvol[procs[w]] += wgts[ibox];
+            }
+        }
+    }
+
+    if (eff || verbose)
+    {
+        const Real max_wgt = *std::max_element(procvol.begin(), procvol.end());
+        const Real efficiency = totalvol/(nprocs*max_wgt);
+        if (eff) *eff = efficiency;
+
+        if (verbose)
+        {
+            amrex::Print() << "Topology-aware efficiency over " << nnodes << " nodes: "
+                           << efficiency << '\n';
+        }
+    }
+
+    return true;
+}
+
+DistributionMapping::CommVolume
+DistributionMapping::PredictCommVolume (const BoxArray& ba, const DistributionMapping& dm,
+                                        const IntVect& ngrow)
+{
+    BL_PROFILE("DistributionMapping::PredictCommVolume()");
+
+    CommVolume r;
+
+    const int N = ba.size();
+    const int nprocs = ParallelContext::NProcsSub();
+    const std::vector<int>& node_of_proc = nodeOfProc(nprocs);
+    std::vector<Long> recv(nprocs, 0);
+    std::vector<Real> load(nprocs, 0);
+    std::set<std::pair<int,int> > pairs;
+    std::vector<std::pair<int,Box> > isects;
+
+    for (int i = 0; i < N; ++i)
+    {
+        const int ri = ParallelContext::global_to_local_rank(dm[i]);
+        load[ri] += ba[i].numPts();
+        ba.intersections(amrex::grow(ba[i],ngrow), isects);
+        for (auto const& is : isects) {
+            const int rj = ParallelContext::global_to_local_rank(dm[is.first]);
+            if (ri != rj) {
+                recv[ri] += is.second.numPts();
+                pairs.insert(std::make_pair(ri,rj));
+                if (node_of_proc[ri] != node_of_proc[rj]) {
+                    r.internode += is.second.numPts();
+                }
+            }
+        }
+    }
+
+    for (Long v : recv) {
+        r.total += v;
+        r.max_per_proc = std::max(r.max_per_proc, v);
+    }
+    r.nmessages = pairs.size();
+
+    const Real maxload = *std::max_element(load.begin(), load.end());
+    if (maxload > 0) {
+        r.efficiency = std::accumulate(load.begin(), load.end(), Real(0)) / (nprocs*maxload);
+    }
+
+    return r;
+}
+
+Vector<std::pair<DistributionMapping::Strategy,DistributionMapping::CommVolume> >
+DistributionMapping::CommReport (const BoxArray& ba, const IntVect& ngrow, bool a_verbose)
+{
+    BL_PROFILE("DistributionMapping::CommReport()");
+
+    const Strategy saved = strategy();
+
+    Vector<std::pair<Strategy,CommVolume> > r;
+    for (Strategy how : {ROUNDROBIN, SFC, HILBERT, GRAPH})
+    {
+        strategy(how);
+        DistributionMapping dm(ba, ParallelContext::NProcsSub());
+        r.emplace_back(how, PredictCommVolume(ba, dm, ngrow));
+    }
+
+    strategy(saved);
+
+    if (a_verbose)
+    {
+        const char* names[] = {"ROUNDROBIN", "KNAPSACK", "SFC", "RRSFC", "HILBERT", "GRAPH"};
+        amrex::Print() << "DistributionMapping communication report for " << ba.size()
+                       << " boxes with " << ngrow << " ghost cells:\n";
+        for (auto const& sc : r) {
+            amrex::Print() << "  " << std::setw(10) << names[sc.first]
+                           << ": total " << sc.second.total
+                           << ", max per proc " << sc.second.max_per_proc
+                           << ", messages " << sc.second.nmessages
+                           << ", inter-node " << sc.second.internode
+                           << ", efficiency " << sc.second.efficiency << "\n";
+        }
+    }
+
+    return r;
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost, int nmax)
 {
@@ -1557,6 +2188,24 @@ DistributionMapping::ComputeDistributionMappingEfficiency (const DistributionMap
                                    rankToCost.end(), 0.0_rt) / (nprocs*maxCost));
 }
 
+void
+DistributionMapping::ComputeDistributionMappingEfficiency (const LayoutData<Real>& cost,
+                                                           Real* efficiency)
+{
+    Real mycost = 0.0_rt;
+    for (MFIter mfi(cost); mfi.isValid(); ++mfi) {
+        mycost += cost[mfi];
+    }
+
+    Real sumCost = mycost;
+    Real maxCost = mycost;
+    ParallelDescriptor::ReduceRealSum(sumCost);
+    ParallelDescriptor::ReduceRealMax(maxCost);
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    *efficiency = (maxCost > 0.0_rt) ? sumCost / (nprocs*maxCost) : 1.0_rt;
+}
+
 namespace {
 Vector<Long>
 gather_weights (const MultiFab& weight)
@@ -1788,6 +2437,72 @@ DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol, const int np
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeIncremental (const BoxArray& ba, const BoxArray& old_ba,
+                                      const DistributionMapping& old_dm)
+{
+    BL_PROFILE("makeIncremental");
+
+    const int nprocs = ParallelContext::NProcsSub();
+    const int N = ba.size();
+
+    Vector<int> pmap(N, -1);
+    Vector<Long> load(nprocs, 0);
+    Vector<int> owner(N, -1);
+    Long max_box = 0;
+
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = ba[i];
+        max_box = std::max(max_box, bx.numPts());
+        old_ba.intersections(bx, isects);
+        if (isects.size() == 1 && old_ba[isects[0].first] == bx)
+        {
+            owner[i] = ParallelContext::global_to_local_rank(old_dm[isects[0].first]);
+            if (owner[i] >= 0) {
+                pmap[i] = old_dm[isects[0].first];
+                load[owner[i]] += bx.numPts();
+            }
+        }
+        else
+        {
+            // The process that already has most of the data of this box
+            Long best = 0;
+            for (auto const& is : isects) {
+                const int rank = ParallelContext::global_to_local_rank(old_dm[is.first]);
+                if (rank >= 0 && is.second.numPts() > best) {
+                    best = is.second.numPts();
+                    owner[i] = rank;
+                }
+            }
+        }
+    }
+
+    const Long target = ba.numPts() / nprocs + max_box;
+
+    // Largest boxes first, so that the small ones even out the load.
+    Vector<int> changed;
+    for (int i = 0; i < N; ++i) {
+        if (pmap[i] < 0) changed.push_back(i);
+    }
+    std::stable_sort(changed.begin(), changed.end(),
+                     [&] (int a, int b) { return ba[a].numPts() > ba[b].numPts(); });
+
+    for (int i : changed)
+    {
+        const Long npts = ba[i].numPts();
+        int rank = owner[i];
+        if (rank < 0 || load[rank] + npts > target) {
+            rank = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+        }
+        load[rank] += npts;
+        pmap[i] = ParallelContext::local_to_global_rank(rank);
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
 const Vector<int>&
 DistributionMapping::getIndexArray ()
 {
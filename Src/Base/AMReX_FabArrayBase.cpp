@@ -30,6 +30,8 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::persistent_fillboundary = false;
+bool    FabArrayBase::cache_fillpatch_data = false;
 
 #if defined(AMREX_USE_GPU)
 
@@ -74,6 +76,8 @@ std::multimap<FabArrayBase::BDKey,FabArrayBase::ParForInfo*> FabArrayBase::m_The
 
 FabArrayBase::CacheStats           FabArrayBase::m_TAC_stats("TileArrayCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FBC_stats("FBCache");
+MPI_Comm                           FabArrayBase::m_persistent_comm = MPI_COMM_NULL;
+int                                FabArrayBase::m_persistent_tag = 0;
 FabArrayBase::CacheStats           FabArrayBase::m_CPC_stats("CopyCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FPinfo_stats("FillPatchCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CFinfo_stats("CrseFineCache");
@@ -122,6 +126,18 @@ FabArrayBase::Initialize ()
         MaxComp = 1;
     }
 
+    pp.queryAdd("persistent_fillboundary", FabArrayBase::persistent_fillboundary);
+    pp.queryAdd("cache_fillpatch_data", FabArrayBase::cache_fillpatch_data);
+
+#ifdef BL_USE_MPI
+    if (persistent_fillboundary && ParallelDescriptor::NProcs() > 1) {
+        // Persistent plans get a communicator of their own so that their fixed
+        // tags can never match the messages of other communication.
+        MPI_Comm_dup(ParallelDescriptor::Communicator(), &m_persistent_comm);
+        m_persistent_tag = 0;
+    }
+#endif
+
 #ifdef AMREX_USE_GPU
     if (ParallelDescriptor::UseGpuAwareMpi()) {
         the_fa_arena = The_Arena();
@@ -1033,6 +1049,20 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
 FabArrayBase::FB::~FB ()
 {}
 
+FabArrayBase::FBPersistentPlan::~FBPersistentPlan ()
+{
+#ifdef BL_USE_MPI
+    for (auto& req : recv_reqs) {
+        if (req != MPI_REQUEST_NULL) { MPI_Request_free(&req); }
+    }
+    for (auto& req : send_reqs) {
+        if (req != MPI_REQUEST_NULL) { MPI_Request_free(&req); }
+    }
+#endif
+    if (the_recv_data) { The_FA_Arena()->free(the_recv_data); }
+    if (the_send_data) { The_FA_Arena()->free(the_send_data); }
+}
+
 void
 FabArrayBase::flushFB (bool no_assertion) const
 {
@@ -1814,12 +1844,116 @@ FabArrayBase::FPinfo::~FPinfo ()
 {
 }
 
+FabArrayBase*
+FabArrayBase::FPinfo::getPatch (int role, int ncomp, IndexType ixtype,
+                                std::type_info const& type) const
+{
+    for (auto const& p : m_patches) {
+        if (p.role == role && p.ncomp == ncomp && p.ixtype == ixtype &&
+            p.type == std::type_index(type))
+        {
+            return p.fa.get();
+        }
+    }
+    return nullptr;
+}
+
+FabArrayBase&
+FabArrayBase::FPinfo::setPatch (int role, int ncomp, IndexType ixtype,
+                                std::type_info const& type,
+                                std::unique_ptr<FabArrayBase> fa, Long nbytes) const
+{
+    BL_ASSERT(getPatch(role, ncomp, ixtype, type) == nullptr);
+#ifdef AMREX_MEM_PROFILING
+    const Long old_bytes = bytes();
+#endif
+    m_patches.push_back(Patch{role, ncomp, ixtype, std::type_index(type), std::move(fa), nbytes});
+#ifdef AMREX_MEM_PROFILING
+    // The FPinfo is already in the cache, whose size grows with the patch.
+    m_FPinfo_stats.bytes += bytes() - old_bytes;
+    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
+#endif
+    return *m_patches.back().fa;
+}
+
 Long
 FabArrayBase::FPinfo::bytes () const
 {
     Long cnt = sizeof(FabArrayBase::FPinfo);
     cnt += sizeof(Box) * (ba_crse_patch.capacity() + ba_fine_patch.capacity());
     cnt += sizeof(int) * dm_patch.capacity();
+    cnt += sizeof(Patch) * m_patches.capacity();
+    cnt += sizeof(Box) * m_crse_grids.ba.size();
+    cnt += sizeof(int) * (m_crse_grids.dm.size() + m_crse_grids.index.capacity());
+    return cnt;
+}
+
+const FabArrayBase::FPinfo::CrseGrids&
+FabArrayBase::FPinfo::getCrseGrids (const BoxArray& cba, const DistributionMapping& cdm,
+                                    const Periodicity& period) const
+{
+    if (m_crse_grids.crse_ba.getRefID() == cba.getRefID() &&
+        m_crse_grids.crse_dm.getRefID() == cdm.getRefID())
+    {
+        return m_crse_grids;
+    }
+
+    BL_PROFILE("FPinfo::getCrseGrids()");
+
+#ifdef AMREX_MEM_PROFILING
+    const Long old_bytes = bytes();
+#endif
+    //
+    // The patches on the grids of the previous coarse layout are of no more use.
+    //
+    const BoxArray::RefID old_id = m_crse_grids.ba.getRefID();
+    m_patches.erase(std::remove_if(m_patches.begin(), m_patches.end(),
+                                   [&] (Patch const& p) { return p.fa->boxArray().getRefID() == old_id; }),
+                    m_patches.end());
+
+    Vector<char> needed(cba.size(), 0);
+    std::vector< std::pair<int,Box> > isects;
+    for (const auto& iv : period.shiftIntVect()) {
+        for (int i = 0, N = ba_crse_patch.size(); i < N; ++i) {
+            cba.intersections(ba_crse_patch[i]+iv, isects);
+            for (auto const& is : isects) {
+                needed[is.first] = 1;
+            }
+        }
+    }
+
+    BoxList bl(cba.ixType());
+    Vector<int> pmap;
+    Vector<int> index;
+    for (int i = 0, N = cba.size(); i < N; ++i) {
+        if (needed[i]) {
+            bl.push_back(cba[i]);
+            pmap.push_back(cdm[i]);
+            index.push_back(i);
+        }
+    }
+
+    m_crse_grids.ba = BoxArray(std::move(bl));
+    m_crse_grids.dm = DistributionMapping(std::move(pmap));
+    m_crse_grids.index = std::move(index);
+    m_crse_grids.crse_ba = cba;
+    m_crse_grids.crse_dm = cdm;
+
+#ifdef AMREX_MEM_PROFILING
+    m_FPinfo_stats.bytes += bytes() - old_bytes;
+    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
+#endif
+
+    return m_crse_grids;
+}
+
+Long
+FabArrayBase::FPinfo::patchBytes () const
+{
+    Long cnt = 0;
+    for (auto const& p : m_patches) {
+        cnt += p.nbytes;
+    }
     return cnt;
 }
 
@@ -2063,6 +2197,12 @@ void
 FabArrayBase::Finalize ()
 {
     FabArrayBase::flushFBCache();
+#ifdef BL_USE_MPI
+    if (m_persistent_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&m_persistent_comm);
+        m_persistent_comm = MPI_COMM_NULL;
+    }
+#endif
     FabArrayBase::flushCPCache();
     FabArrayBase::flushRB90Cache();
     FabArrayBase::flushRB180Cache();
@@ -1,10 +1,12 @@
 #include <AMReX.H>
+#include <AMReX_Extension.H>
 #include <AMReX_FabConv.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_FPC.H>
 #include <AMReX_REAL.H>
 #include <AMReX_Utility.H>
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -13,6 +15,7 @@
 namespace amrex {
 
 bool RealDescriptor::bAlwaysFixDenormals (false);
+bool RealDescriptor::bUseFastConversions (true);
 int  RealDescriptor::writeBufferSize(262144);  // ---- these are number of reals,
 int  RealDescriptor::readBufferSize(262144);   // ---- not bytes
 
@@ -150,6 +153,18 @@ RealDescriptor::SetFixDenormals()
     bAlwaysFixDenormals = true;
 }
 
+void
+RealDescriptor::SetUseFastConversions (bool usefast)
+{
+    bUseFastConversions = usefast;
+}
+
+bool
+RealDescriptor::GetUseFastConversions ()
+{
+    return bUseFastConversions;
+}
+
 void
 RealDescriptor::SetReadBufferSize(int rbs)
 {
@@ -905,6 +920,164 @@ operator>> (std::istream&   is,
     return is;
 }
 
+//
+// Fast paths for the common conversions between IEEE formats.  These are
+// picked once per call by comparing the descriptors and then run over the
+// whole buffer in loops simple enough for the compiler to vectorize.
+//
+
+namespace
+{
+    enum struct ConvKind { Generic, Identity, ByteReverse, Widen, Narrow };
+
+    AMREX_FORCE_INLINE
+    std::uint32_t swapBytes (std::uint32_t v)
+    {
+        return (v >> 24) | ((v >> 8) & 0x0000ff00U) | ((v << 8) & 0x00ff0000U) | (v << 24);
+    }
+
+    AMREX_FORCE_INLINE
+    std::uint64_t swapBytes (std::uint64_t v)
+    {
+        return (std::uint64_t(swapBytes(std::uint32_t(v))) << 32)
+            | swapBytes(std::uint32_t(v >> 32));
+    }
+
+    //
+    // True if the byte order ord is nat reversed.
+    //
+    bool isReversedOrder (const Vector<int>& ord, const Vector<int>& nat)
+    {
+        const int n = nat.size();
+        if (int(ord.size()) != n) {
+            return false;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (ord[i] != nat[n-1-i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //
+    // 0 if rd is the native format nat, 1 if it is nat byte reversed, else -1.
+    //
+    int nativeOrderOf (const RealDescriptor& rd, const RealDescriptor& nat)
+    {
+        if (rd.formatarray() != nat.formatarray()) {
+            return -1;
+        } else if (rd.orderarray() == nat.orderarray()) {
+            return 0;
+        } else if (isReversedOrder(rd.orderarray(), nat.orderarray())) {
+            return 1;
+        }
+        return -1;
+    }
+
+    //
+    // Identical formats are copied as is, like the generic path always did.
+    // Ones complement input has to take the bit by bit path otherwise.
+    //
+    ConvKind
+    selectConversion (const RealDescriptor& ord,
+                      const RealDescriptor& ird,
+                      int                   onescmp,
+                      bool&                 swapin,
+                      bool&                 swapout)
+    {
+        swapin = swapout = false;
+        if (ord == ird) {
+            return ConvKind::Identity;
+        }
+        if (onescmp || ! RealDescriptor::GetUseFastConversions()) {
+            return ConvKind::Generic;
+        }
+        if (ord.formatarray() == ird.formatarray() &&
+            (ord.numBytes() == 4 || ord.numBytes() == 8) &&
+            isReversedOrder(ord.orderarray(), ird.orderarray()))
+        {
+            return ConvKind::ByteReverse;
+        }
+        int iord = nativeOrderOf(ird, FPC::Native32RealDescriptor());
+        int oord = nativeOrderOf(ord, FPC::Native64RealDescriptor());
+        if (iord >= 0 && oord >= 0) {
+            swapin = iord;
+            swapout = oord;
+            return ConvKind::Widen;
+        }
+        iord = nativeOrderOf(ird, FPC::Native64RealDescriptor());
+        oord = nativeOrderOf(ord, FPC::Native32RealDescriptor());
+        if (iord >= 0 && oord >= 0) {
+            swapin = iord;
+            swapout = oord;
+            return ConvKind::Narrow;
+        }
+        return ConvKind::Generic;
+    }
+
+    template <typename U>
+    void
+    reverseBytes (void* out, const void* in, Long nitems)
+    {
+        auto pin  = static_cast<const char*>(in);
+        auto pout = static_cast<char*>(out);
+AMREX_PRAGMA_SIMD
+        for (Long i = 0; i < nitems; ++i) {
+            U u;
+            std::memcpy(&u, pin + i*sizeof(U), sizeof(U));
+            u = swapBytes(u);
+            std::memcpy(pout + i*sizeof(U), &u, sizeof(U));
+        }
+    }
+
+    //
+    // Convert between IEEE float and double, either of which may be stored
+    // byte reversed.  TI/TO are the types and UI/UO same sized unsigned ints.
+    //
+    template <typename TI, typename UI, typename TO, typename UO, bool SwapIn, bool SwapOut>
+    void
+    convertIEEE (void* out, const void* in, Long nitems)
+    {
+        static_assert(sizeof(TI) == sizeof(UI) && sizeof(TO) == sizeof(UO),
+                      "convertIEEE: type size mismatch");
+        auto pin  = static_cast<const char*>(in);
+        auto pout = static_cast<char*>(out);
+AMREX_PRAGMA_SIMD
+        for (Long i = 0; i < nitems; ++i) {
+            UI u;
+            std::memcpy(&u, pin + i*sizeof(UI), sizeof(UI));
+            if (SwapIn) { u = swapBytes(u); }
+            TI x;
+            std::memcpy(&x, &u, sizeof(TI));
+            TO y = static_cast<TO>(x);
+            UO v;
+            std::memcpy(&v, &y, sizeof(TO));
+            if (SwapOut) { v = swapBytes(v); }
+            std::memcpy(pout + i*sizeof(UO), &v, sizeof(UO));
+        }
+    }
+
+    template <typename TI, typename UI, typename TO, typename UO>
+    void
+    convertIEEE (void* out, const void* in, Long nitems, bool swapin, bool swapout)
+    {
+        if (swapin) {
+            if (swapout) {
+                convertIEEE<TI,UI,TO,UO,true,true>(out, in, nitems);
+            } else {
+                convertIEEE<TI,UI,TO,UO,true,false>(out, in, nitems);
+            }
+        } else {
+            if (swapout) {
+                convertIEEE<TI,UI,TO,UO,false,true>(out, in, nitems);
+            } else {
+                convertIEEE<TI,UI,TO,UO,false,false>(out, in, nitems);
+            }
+        }
+    }
+}
+
 static
 void
 PD_convert (void*                 out,
@@ -917,12 +1090,34 @@ PD_convert (void*                 out,
             int                   onescmp = 0)
 {
 //    BL_PROFILE("PD_convert");
-    if (ord == ird && boffs == 0)
+    bool swapin, swapout;
+    const ConvKind kind = (boffs == 0)
+        ? selectConversion(ord, ird, onescmp, swapin, swapout) : ConvKind::Generic;
+
+    if (kind == ConvKind::Identity)
     {
         size_t n = size_t(nitems);
-        BL_ASSERT(int(n) == nitems);
+        BL_ASSERT(Long(n) == nitems);
         memcpy(out, in, n*ord.numBytes());
     }
+    else if (kind == ConvKind::ByteReverse)
+    {
+        if (ord.numBytes() == 4) {
+            reverseBytes<std::uint32_t>(out, in, nitems);
+        } else {
+            reverseBytes<std::uint64_t>(out, in, nitems);
+        }
+    }
+    else if (kind == ConvKind::Widen)
+    {
+        convertIEEE<float,std::uint32_t,double,std::uint64_t>(out, in, nitems,
+                                                              swapin, swapout);
+    }
+    else if (kind == ConvKind::Narrow)
+    {
+        convertIEEE<double,std::uint64_t,float,std::uint32_t>(out, in, nitems,
+                                                              swapin, swapout);
+    }
     else if (ord.formatarray() == ird.formatarray() && boffs == 0 && ! onescmp) {
         permute_real_word_order(out, in, nitems,
                                 ord.order(), ird.order(), ord.numBytes());
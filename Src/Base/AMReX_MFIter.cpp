@@ -2,7 +2,10 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_Utility.H>
 #include <AMReX_OpenMP.H>
+#include <AMReX_MemPool.H>
 
 namespace amrex {
 
@@ -155,6 +158,9 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm, const MFItInf
     flags(info.do_tiling ? Tiling : 0),
     streams(info.num_streams),
     dynamic(info.dynamic && (OpenMP::get_num_threads() > 1)),
+    halo_width(info.halo_width),
+    halo_ready(info.halo_ready),
+    m_cost(info.cost),
     device_sync(info.device_sync),
     index_map(nullptr),
     local_index_map(nullptr),
@@ -187,6 +193,9 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
     flags(info.do_tiling ? Tiling : 0),
     streams(info.num_streams),
     dynamic(info.dynamic && (OpenMP::get_num_threads() > 1)),
+    halo_width(info.halo_width),
+    halo_ready(info.halo_ready),
+    m_cost(info.cost),
     device_sync(info.device_sync),
     index_map(nullptr),
     local_index_map(nullptr),
@@ -237,6 +246,8 @@ MFIter::~MFIter ()
 #endif
         m_fa->clearThisBD();
     }
+
+    amrex_mempool_end_epoch();
 }
 
 void
@@ -251,6 +262,8 @@ MFIter::Initialize ()
             "Nested or multiple active MFIters is not supported by default.  This can be changed by calling MFIter::allowMultipleMFIters(true)".);
     }
 
+    amrex_mempool_begin_epoch();
+
     if (flags & AllBoxes)  // a very special case
     {
         index_map    = &(fabArray.IndexArray());
@@ -262,6 +275,13 @@ MFIter::Initialize ()
     {
         const FabArrayBase::TileArray* pta = fabArray.getTileArray(tile_size);
 
+        if (halo_width.allGE(IntVect::TheZeroVector()))
+        {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!dynamic, "MFIter: SplitHalo does not support dynamic scheduling");
+            buildSplitTileArray(*pta);
+            pta = split_ta.get();
+        }
+
         index_map            = &(pta->indexMap);
         local_index_map      = &(pta->localIndexMap);
         tile_array           = &(pta->tileArray);
@@ -285,7 +305,7 @@ MFIter::Initialize ()
             }
 #endif
 
-            int ntot = index_map->size();
+            int ntot = split_ta ? n_interior : index_map->size();
 
             if (nworkers == 1)
             {
@@ -338,9 +358,104 @@ MFIter::Initialize ()
 #endif
 
         typ = fabArray.boxArray().ixType();
+
+        if (split_ta && currentIndex >= endIndex) {
+            startHaloPhase();
+        }
+    }
+
+    if (m_cost) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(isMFIterSafe(fabArray, *m_cost),
+                                         "MFIter: MeasureCost needs the same BoxArray and DistributionMapping");
+        m_cost_t0 = amrex::second();
+    }
+}
+
+void
+MFIter::buildSplitTileArray (const FabArrayBase::TileArray& ta)
+{
+    split_ta = std::make_unique<FabArrayBase::TileArray>();
+    FabArrayBase::TileArray& sta = *split_ta;
+
+    //
+    // Tiles are cell-centered.  Cells at least halo_width away from the
+    // boundary of the valid box do not need any ghost cells.
+    //
+    const BoxArray& ba = fabArray.boxArray();
+    Vector<int> tiles, halo_tiles;
+    Vector<Box> halo_boxes;
+    for (int it = 0, N = ta.indexMap.size(); it < N; ++it)
+    {
+        const Box& tbx = ta.tileArray[it];
+        const Box& ibx = amrex::grow(ba.getCellCenteredBox(ta.indexMap[it]), -halo_width) & tbx;
+        if (ibx.ok()) {
+            sta.tileArray.push_back(ibx);
+            tiles.push_back(it);
+        }
+        for (const Box& hbx : amrex::boxDiff(tbx, ibx)) {
+            halo_boxes.push_back(hbx);
+            halo_tiles.push_back(it);
+        }
+    }
+
+    n_interior = sta.tileArray.size();
+    sta.tileArray.insert(sta.tileArray.end(), halo_boxes.begin(), halo_boxes.end());
+    tiles.insert(tiles.end(), halo_tiles.begin(), halo_tiles.end());
+
+    for (int it : tiles) {
+        sta.indexMap.push_back(ta.indexMap[it]);
+        sta.localIndexMap.push_back(ta.localIndexMap[it]);
+        sta.localTileIndexMap.push_back(ta.localTileIndexMap[it]);
+        sta.numLocalTiles.push_back(ta.numLocalTiles[it]);
     }
 }
 
+void
+MFIter::startHaloPhase ()
+{
+#ifdef AMREX_USE_OMP
+#pragma omp barrier
+#pragma omp single
+#endif
+    {
+        if (halo_ready) { halo_ready(); }
+#ifdef AMREX_USE_GPU
+        Gpu::synchronize();
+#endif
+    }
+
+    halo_phase = true;
+    beginIndex = n_interior;
+    endIndex = index_map->size();
+
+#ifdef AMREX_USE_OMP
+    int nthreads = omp_get_num_threads();
+    if (nthreads > 1)
+    {
+        int tid = omp_get_thread_num();
+        int ntot = endIndex - beginIndex;
+        int nr   = ntot / nthreads;
+        int nlft = ntot - nr * nthreads;
+        if (tid < nlft) {  // get nr+1 items
+            beginIndex += tid * (nr + 1);
+            endIndex = beginIndex + nr + 1;
+        } else {           // get nr items
+            beginIndex += tid * nr + nlft;
+            endIndex = beginIndex + nr;
+        }
+    }
+#endif
+
+    currentIndex = beginIndex;
+
+#ifdef AMREX_USE_GPU
+    Gpu::Device::setStreamIndex((streams > 0) ? currentIndex%streams : -1);
+#endif
+
+    // Do not charge the wait for the halo to any box.
+    if (m_cost) { m_cost_t0 = amrex::second(); }
+}
+
 Box
 MFIter::tilebox () const noexcept
 {
@@ -481,6 +596,8 @@ MFIter::grownnodaltilebox (int dir, IntVect const& a_ng) const noexcept
 void
 MFIter::operator++ () noexcept
 {
+    if (m_cost) { addCost(); }
+
 #ifdef AMREX_USE_OMP
     if (dynamic)
     {
@@ -501,7 +618,27 @@ MFIter::operator++ () noexcept
 #endif
         }
 #endif
+
+        if (split_ta && !halo_phase && currentIndex >= endIndex) {
+            startHaloPhase();
+        }
     }
 }
 
+void
+MFIter::addCost ()
+{
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) { Gpu::streamSynchronize(); }
+#endif
+    const double t = amrex::second();
+    Real& c = (*m_cost)[*this];
+    const auto dt = static_cast<Real>(t - m_cost_t0);
+#ifdef AMREX_USE_OMP
+#pragma omp atomic
+#endif
+    c += dt;
+    m_cost_t0 = t;
+}
+
 }
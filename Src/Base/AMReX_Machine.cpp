@@ -217,8 +217,11 @@ class Machine
         get_params();
         get_machine_envs();
         node_ids = get_node_ids();
+        shm_node_ids = get_shm_node_ids();
     }
 
+    const Vector<int>& shared_memory_node_ids () const { return shm_node_ids; }
+
     // find a compact neighborhood of size rank_n in the current ParallelContext subgroup
     Vector<int> find_best_nbh (int nbh_rank_n, bool flag_local_ranks)
     {
@@ -323,6 +326,7 @@ class Machine
     bool flag_nersc_df;
     // int my_node_id;
     Vector<int> node_ids;
+    Vector<int> shm_node_ids;
 
     NeighborhoodCache nbh_cache;
 
@@ -410,6 +414,40 @@ class Machine
         return result;
     }
 
+    // get the shared-memory node of all ranks in this job, numbered in order of
+    // their lowest rank.  this is collective over ALL ranks in the job
+    Vector<int> get_shm_node_ids ()
+    {
+        MPI_Comm comm_all = ParallelContext::CommunicatorAll();
+        int rank_me;
+        MPI_Comm_rank(comm_all, &rank_me);
+        MPI_Comm shm_comm;
+        MPI_Comm_split_type(comm_all, MPI_COMM_TYPE_SHARED, rank_me, MPI_INFO_NULL, &shm_comm);
+        int leader = rank_me;
+        MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_MIN, shm_comm);
+        MPI_Comm_free(&shm_comm);
+
+        Vector<int> leaders(ParallelDescriptor::NProcs());
+        ParallelAllGather::AllGather(leader, leaders.data(), comm_all);
+
+        std::map<int, int> leader_to_node;
+        for (int l : leaders) {
+            leader_to_node.emplace(l, 0);
+        }
+        int inode = 0;
+        for (auto& kv : leader_to_node) {
+            kv.second = inode++;
+        }
+        Vector<int> ids(leaders.size());
+        for (int i = 0; i < ids.size(); ++i) {
+            ids[i] = leader_to_node[leaders[i]];
+        }
+        if (flag_verbose) {
+            Print() << "Machine: " << leader_to_node.size() << " shared-memory nodes" << std::endl;
+        }
+        return ids;
+    }
+
     // get all node IDs in this job, indexed by job rank
     // this is collective over ALL ranks in the job
     Vector<int> get_node_ids ()
@@ -595,6 +633,11 @@ Vector<int> find_best_nbh (int rank_n, bool flag_local_ranks) {
     return the_machine->find_best_nbh(rank_n, flag_local_ranks);
 }
 
+const Vector<int>& shared_memory_node_ids () {
+    AMREX_ASSERT(the_machine);
+    return the_machine->shared_memory_node_ids();
+}
+
 }}
 
 #endif
@@ -28,6 +28,94 @@ namespace
     static int init_snan = 0;
 #endif
     static bool initialized = false;
+
+    //
+    // Per-thread bump allocator for the temporaries of The_MemPool_Arena()
+    // inside MFIter loops.  The memory is reclaimed all at once when the
+    // last of its allocations is freed, which for scratch data is at the
+    // end of every iteration.
+    //
+    struct alignas(64) BumpPool
+    {
+        std::vector<std::pair<char*,std::size_t> > chunks;
+        std::size_t offset = 0; // into chunks.back()
+        Long nlive = 0;         // allocations not freed yet
+        int depth = 0;
+    };
+
+    static Vector<BumpPool> the_bump_pool;
+    static bool use_bump_alloc = false;
+    static Long bump_chunk_size = 1024*1024*16;
+
+    void* bump_alloc (BumpPool& bp, CArena& arena, std::size_t nbytes)
+    {
+        nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+        if (bp.chunks.empty() || bp.offset + nbytes > bp.chunks.back().second) {
+            const std::size_t n = std::max(nbytes, static_cast<std::size_t>(bump_chunk_size));
+            bp.chunks.emplace_back(static_cast<char*>(arena.alloc(n)), n);
+            bp.offset = 0;
+        }
+        char* p = bp.chunks.back().first + bp.offset;
+        bp.offset += nbytes;
+        ++bp.nlive;
+        return p;
+    }
+
+    bool bump_owns (BumpPool const& bp, void* p)
+    {
+        for (auto const& c : bp.chunks) {
+            if (p >= c.first && p < c.first + c.second) { return true; }
+        }
+        return false;
+    }
+
+    void bump_reset (BumpPool& bp, CArena& arena)
+    {
+        if (bp.chunks.size() > 1) {
+            // Replace the chunks with one that fits all of them next time.
+            std::size_t n = 0;
+            for (auto const& c : bp.chunks) {
+                n += c.second;
+                arena.free(c.first);
+            }
+            bp.chunks.clear();
+            bp.chunks.emplace_back(static_cast<char*>(arena.alloc(n)), n);
+        }
+        bp.offset = 0;
+    }
+
+    class MemPoolArena
+        : public Arena
+    {
+    public:
+        MemPoolArena () { arena_info.SetCpuMemory(); }
+
+        virtual void* alloc (std::size_t nbytes) override
+        {
+            if (use_bump_alloc) {
+                int tid = OpenMP::get_thread_num();
+                if (the_bump_pool[tid].depth > 0) {
+                    return bump_alloc(the_bump_pool[tid], *the_memory_pool[tid], nbytes);
+                }
+            }
+            return amrex_mempool_alloc(nbytes);
+        }
+
+        virtual void free (void* p) override
+        {
+            if (use_bump_alloc) {
+                int tid = OpenMP::get_thread_num();
+                auto& bp = the_bump_pool[tid];
+                if (bump_owns(bp, p)) {
+                    if (--bp.nlive == 0) {
+                        bump_reset(bp, *the_memory_pool[tid]);
+                    }
+                    return;
+                }
+            }
+            amrex_mempool_free(p);
+        }
+    };
 }
 
 extern "C" {
@@ -41,12 +129,18 @@ void amrex_mempool_init ()
         ParmParse pp("fab");
         pp.queryAdd("init_snan", init_snan);
 
+        ParmParse ppa("amrex");
+        ppa.queryAdd("mempool_bump_alloc", use_bump_alloc);
+        ppa.queryAdd("mempool_bump_chunk_size", bump_chunk_size);
+
         int nthreads = OpenMP::get_max_threads();
 
         the_memory_pool.resize(nthreads);
         for (int i=0; i<nthreads; ++i) {
             the_memory_pool[i] = std::make_unique<CArena>(0, ArenaInfo().SetCpuMemory());
         }
+        the_bump_pool.clear();
+        the_bump_pool.resize(nthreads);
 
 #ifdef AMREX_USE_OMP
 #pragma omp parallel num_threads(nthreads)
@@ -73,7 +167,9 @@ void amrex_mempool_init ()
 void amrex_mempool_finalize ()
 {
     initialized = false;
+    the_bump_pool.clear();
     the_memory_pool.clear();
+    use_bump_alloc = false;
 }
 
 void* amrex_mempool_alloc (size_t nbytes)
@@ -88,6 +184,22 @@ void amrex_mempool_free (void* p)
   the_memory_pool[tid]->free(p);
 }
 
+void amrex_mempool_begin_epoch ()
+{
+  if (use_bump_alloc) {
+      int tid = OpenMP::get_thread_num();
+      ++the_bump_pool[tid].depth;
+  }
+}
+
+void amrex_mempool_end_epoch ()
+{
+  if (use_bump_alloc) {
+      int tid = OpenMP::get_thread_num();
+      --the_bump_pool[tid].depth;
+  }
+}
+
 void amrex_mempool_get_stats (int& mp_min, int& mp_max, int& mp_tot) // min, max & tot in MB
 {
   size_t hsu_min=std::numeric_limits<size_t>::max();
@@ -109,6 +221,24 @@ void amrex_real_array_init (Real* p, size_t nelems)
     if (init_snan) amrex_array_init_snan(p, nelems);
 }
 
+}
+
+namespace amrex {
+
+Arena* The_MemPool_Arena ()
+{
+#ifdef AMREX_USE_GPU
+    return The_Async_Arena();
+#else
+    static MemPoolArena the_mempool_arena;
+    return &the_mempool_arena;
+#endif
+}
+
+}
+
+extern "C" {
+
 void amrex_array_init_snan (Real* p, size_t nelems)
 {
 #ifdef BL_USE_DOUBLE
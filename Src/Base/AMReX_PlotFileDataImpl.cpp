@@ -142,4 +142,36 @@ PlotFileDataImpl::get (int level, std::string const& varname) noexcept
     return mf;
 }
 
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid) noexcept
+{
+    std::unique_ptr<FArrayBox> fab;
+#ifndef AMREX_USE_GPU
+    fab.reset(m_vismf[level]->mapFAB(gid));
+#endif
+    if (!fab) {
+        fab.reset(m_vismf[level]->readFAB(gid, -1));
+    }
+    return std::move(*fab);
+}
+
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid, std::string const& varname) noexcept
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::getFab: varname not found "+varname);
+        return FArrayBox();
+    }
+    int icomp = std::distance(std::begin(m_var_names), r);
+    std::unique_ptr<FArrayBox> fab;
+#ifndef AMREX_USE_GPU
+    fab.reset(m_vismf[level]->mapFAB(gid, icomp));
+#endif
+    if (!fab) {
+        fab.reset(m_vismf[level]->readFAB(gid, icomp));
+    }
+    return std::move(*fab);
+}
+
 }
@@ -4,11 +4,20 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_VisMFCompress.H>
 
 #include <cerrno>
+#include <cstdint>
 #include <cstdio>
 #include <limits>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace amrex {
 
 static const char *TheMultiFabHdrFileSuffix = "_H";
@@ -16,6 +25,7 @@ static const char *FabFileSuffix = "_D_";
 static const char *TheFabOnDiskPrefix = "FabOnDisk:";
 
 std::map<std::string, VisMF::PersistentIFStream> VisMF::persistentIFStreams;
+std::map<std::string, std::shared_ptr<VisMF::MappedFile> > VisMF::mappedFiles;
 
 int VisMF::verbose(0);
 VisMF::Header::Version VisMF::currentVersion(VisMF::Header::Version_v1);
@@ -27,7 +37,9 @@ bool VisMF::checkFilePositions(false);
 bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
+bool VisMF::useMemoryMappedReads(false);
 bool VisMF::allowSparseWrites(true);
+Real VisMF::compressionTolerance(0.0);
 
 Long VisMFBuffer::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -40,6 +52,20 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // An input buffer over memory, used to parse fab headers in mapped files.
+    //
+    class MemoryBuf
+        : public std::streambuf
+    {
+    public:
+        MemoryBuf (const char* p, Long n) {
+            char* b = const_cast<char*>(p);
+            setg(b, b, b + n);
+        }
+        Long consumed () const { return gptr() - eback(); }
+    };
 }
 
 void
@@ -74,8 +100,10 @@ VisMF::Initialize ()
     pp.queryAdd("usepersistentifstreams", usePersistentIFStreams);
     pp.queryAdd("usesynchronousreads", useSynchronousReads);
     pp.queryAdd("usedynamicsetselection", useDynamicSetSelection);
+    pp.queryAdd("usememorymappedreads", useMemoryMappedReads);
     pp.queryAdd("iobuffersize", ioBufferSize);
     pp.queryAdd("allowsparsewrites", allowSparseWrites);
+    pp.queryAdd("compressiontolerance", compressionTolerance);
 
     initialized = true;
 }
@@ -83,6 +111,7 @@ VisMF::Initialize ()
 void
 VisMF::Finalize ()
 {
+    mappedFiles.clear();
     initialized = false;
 }
 
@@ -280,7 +309,9 @@ operator<< (std::ostream        &os,
       os << hd.m_max      << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
+    {
       BL_ASSERT(hd.m_famin.size() == hd.m_ncomp);
       BL_ASSERT(hd.m_famin.size() == hd.m_famax.size());
       for(int i(0); i < hd.m_famin.size(); ++i) {
@@ -295,7 +326,8 @@ operator<< (std::ostream        &os,
 
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         os << FPC::NativeRealDescriptor() << '\n';
@@ -306,6 +338,13 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      os << hd.m_fabBytes.size() << '\n';
+      for(int i(0); i < hd.m_fabBytes.size(); ++i) {
+        os << hd.m_fabBytes[i] << '\n';
+      }
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -366,7 +405,9 @@ operator>> (std::istream  &is,
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
+    {
       char ch;
       hd.m_famin.resize(hd.m_ncomp);
       hd.m_famax.resize(hd.m_ncomp);
@@ -385,11 +426,22 @@ operator>> (std::istream  &is,
     }
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_writtenRD;
     }
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      Long nfabs;
+      is >> nfabs;
+      BL_ASSERT(nfabs == 0 || nfabs == hd.m_ba.size());
+      hd.m_fabBytes.resize(nfabs);
+      for(Long i(0); i < nfabs; ++i) {
+        is >> hd.m_fabBytes[i];
+      }
+    }
+
 
     if( ! is.good()) {
         amrex::Error("Read of VisMF::Header failed");
@@ -660,7 +712,7 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
     bool run_on_device = Gpu::inLaunchRegion()
         && (mf.arena()->isManaged() || mf.arena()->isDevice());
 
-    if(version == NoFabHeaderFAMinMax_v1) {
+    if(version == NoFabHeaderFAMinMax_v1 || version == Compressed_v1) {
       // ---- calculate FabArray min max values only
       m_min.clear();
       m_max.clear();
@@ -974,9 +1026,14 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     std::string filePrefix(mf_name + FabFileSuffix);
 
+    // ---- the data files are about to be rewritten, stale mappings must go
+    VisMF::UnmapFiles(filePrefix);
+
     NFilesIter nfi(nOutFiles, filePrefix, groupSets, setBuf);
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
+    bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    Vector<Long> compressedInfo;  // ---- [file number, offset, bytes] for each local fab
 
     if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
@@ -984,6 +1041,35 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         nfi.SetDynamic();
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
+        if(compressed) {
+            // ---- each fab is one block, its size is only known after compressing
+            Vector<char> block;
+            for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                const FArrayBox &fab = mf[mfi];
+                Real const* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+                std::unique_ptr<FArrayBox> hostfab;
+                if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+                    hostfab = std::make_unique<FArrayBox>(fab.box(), fab.nComp(),
+                                                          The_Pinned_Arena());
+                    Gpu::dtoh_memcpy_async(hostfab->dataPtr(), fab.dataPtr(),
+                                           fab.size()*sizeof(Real));
+                    Gpu::streamSynchronize();
+                    fabdata = hostfab->dataPtr();
+                }
+#endif
+                VisMFCompress::Compress(fabdata, fab.box().numPts() * mf.nComp(),
+                                        *whichRD, compressionTolerance, block);
+                compressedInfo.push_back(nfi.FileNumber());
+                compressedInfo.push_back(VisMF::FileOffset(nfi.Stream()));
+                compressedInfo.push_back(block.size());
+                nfi.Stream().write(block.data(), block.size());
+                bytesWritten += block.size();
+            }
+            nfi.Stream().flush();
+            continue;
+        }
+
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
         int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1101,8 +1187,13 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
-    VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
-                       ParallelDescriptor::Communicator());
+    if(compressed) {
+        VisMF::GatherCompressedOffsets(mf, filePrefix, hdr, compressedInfo, coordinatorProc,
+                                       ParallelDescriptor::Communicator());
+    } else {
+        VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
+                           ParallelDescriptor::Communicator());
+    }
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
@@ -1302,6 +1393,80 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::GatherCompressedOffsets (const FabArray<FArrayBox> &mf,
+                                const std::string &filePrefix,
+                                VisMF::Header &hdr,
+                                const Vector<Long> &localInfo,
+                                int coordinatorProc, MPI_Comm comm)
+{
+    const int nInfo(3);
+    const int myProc(ParallelDescriptor::MyProc(comm));
+    const int nProcs(ParallelDescriptor::NProcs(comm));
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+
+    BL_ASSERT(localInfo.size() == nInfo * mf.local_size());
+
+    Vector<Long> allInfo;
+    Vector<int> offset(nProcs,0);
+
+#ifdef BL_USE_MPI
+    Vector<int> nmtags(nProcs,0);
+
+    for(int i(0), N(mf.size()); i < N; ++i) {
+        nmtags[pmap[i]] += nInfo;
+    }
+
+    for(int i(1), N(offset.size()); i < N; ++i) {
+        offset[i] = offset[i-1] + nmtags[i-1];
+    }
+
+    Vector<Long> senddata(localInfo);
+    if(senddata.empty()) {
+      // Can't let senddata be empty as senddata.dataPtr() will fail.
+      senddata.resize(1);
+    }
+
+    if(myProc == coordinatorProc) {
+        allInfo.resize(nInfo * mf.size());
+    } else {
+        allInfo.resize(1);
+    }
+
+    BL_COMM_PROFILE(BLProfiler::Gatherv, allInfo.size() * sizeof(Long),
+                    myProc, BLProfiler::BeforeCall());
+
+    BL_MPI_REQUIRE( MPI_Gatherv(senddata.dataPtr(),
+                                localInfo.size(),
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                allInfo.dataPtr(),
+                                nmtags.dataPtr(),
+                                offset.dataPtr(),
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                coordinatorProc,
+                                comm) );
+
+    BL_COMM_PROFILE(BLProfiler::Gatherv, allInfo.size() * sizeof(Long),
+                    myProc, BLProfiler::AfterCall());
+#else
+    allInfo = localInfo;
+#endif
+
+    if(myProc == coordinatorProc) {
+        hdr.m_fabBytes.resize(mf.size());
+        for(int j(0), N(mf.size()); j < N; ++j) {
+            const int i(pmap[j]);
+            const Long *info = allInfo.dataPtr() + offset[i];
+            hdr.m_fod[j].m_name = VisMF::BaseName(NFilesIter::FileName(static_cast<int>(info[0]),
+                                                                       filePrefix));
+            hdr.m_fod[j].m_head = info[1];
+            hdr.m_fabBytes[j]   = info[2];
+            offset[i] += nInfo;
+        }
+    }
+}
+
+
 void
 VisMF::RemoveFiles(const std::string &mf_name, bool a_verbose)
 {
@@ -1366,6 +1531,25 @@ VisMF::~VisMF ()
 }
 
 
+//
+// Read the Compressed_v1 block of fab idx from a stream positioned at its
+// start and decompress all of its components into host memory.
+//
+static
+void
+readCompressedBlock (std::istream &is, const VisMF::Header &hdr, int idx,
+                     Real *fabdata, Long nitems)
+{
+    BL_ASSERT(hdr.m_fabBytes.size() == hdr.m_ba.size());
+    Vector<char> block(hdr.m_fabBytes[idx]);
+    is.read(block.dataPtr(), block.size());
+    if( ! is.good()) {
+        amrex::Error("VisMF: read of compressed FAB failed");
+    }
+    VisMFCompress::Decompress(block.dataPtr(), block.size(), fabdata, nitems, hdr.m_writtenRD);
+}
+
+
 FArrayBox*
 VisMF::readFAB (int                  idx,
                 const std::string   &mf_name,
@@ -1383,10 +1567,44 @@ VisMF::readFAB (int                  idx,
     std::string FullName(VisMF::DirName(mf_name));
     FullName += hdr.m_fod[idx].m_name;
 
+    if(useMemoryMappedReads) {
+        auto mfile = VisMF::MapFile(FullName);
+        if(mfile && VisMF::readMappedFAB(*mfile, hdr, idx, *fab, whichComp)) {
+            return fab;
+        }
+    }
+
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(hdr.m_vers == Header::Version_v1) {
+    if(IsCompressed(hdr)) {
+      // ---- the block holds every component, so a single one goes through a temporary
+      Real* fabdata = fab->dataPtr();
+      std::unique_ptr<FArrayBox> hostfab;
+      if(whichComp != -1) {
+          hostfab = std::make_unique<FArrayBox>(fab_box, hdr.m_ncomp, The_Pinned_Arena());
+          fabdata = hostfab->dataPtr();
+      }
+#ifdef AMREX_USE_GPU
+      else if (fab->arena()->isManaged() || fab->arena()->isDevice()) {
+          hostfab = std::make_unique<FArrayBox>(fab->box(), fab->nComp(), The_Pinned_Arena());
+          fabdata = hostfab->dataPtr();
+      }
+#endif
+      readCompressedBlock(*infs, hdr, idx, fabdata, fab_box.numPts() * hdr.m_ncomp);
+      if (hostfab) {
+          Real const* src = hostfab->dataPtr(whichComp == -1 ? 0 : whichComp);
+#ifdef AMREX_USE_GPU
+          if (fab->arena()->isManaged() || fab->arena()->isDevice()) {
+              Gpu::htod_memcpy_async(fab->dataPtr(), src, fab->size()*sizeof(Real));
+              Gpu::streamSynchronize();
+          } else
+#endif
+          {
+              std::memcpy(fab->dataPtr(), src, fab->size()*sizeof(Real));
+          }
+      }
+    } else if(hdr.m_vers == Header::Version_v1) {
       if(whichComp == -1) {    // ---- read all components
         fab->readFrom(*infs);
       } else {
@@ -1447,10 +1665,33 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::string FullName(VisMF::DirName(mf_name));
     FullName += hdr.m_fod[idx].m_name;
 
+    if(useMemoryMappedReads) {
+        auto mfile = VisMF::MapFile(FullName);
+        if(mfile && VisMF::readMappedFAB(*mfile, hdr, idx, fab, -1)) {
+            return;
+        }
+    }
+
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(IsCompressed(hdr)) {
+      Real* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+      std::unique_ptr<FArrayBox> hostfab;
+      if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+          hostfab = std::make_unique<FArrayBox>(fab.box(), fab.nComp(), The_Pinned_Arena());
+          fabdata = hostfab->dataPtr();
+      }
+#endif
+      readCompressedBlock(*infs, hdr, idx, fabdata, fab.box().numPts() * fab.nComp());
+#ifdef AMREX_USE_GPU
+      if (hostfab) {
+          Gpu::htod_memcpy_async(fab.dataPtr(), hostfab->dataPtr(), fab.size()*sizeof(Real));
+          Gpu::streamSynchronize();
+      }
+#endif
+    } else if(NoFabHeader(hdr)) {
       Real* fabdata = fab.dataPtr();
 #ifdef AMREX_USE_GPU
       std::unique_ptr<FArrayBox> hostfab;
@@ -1955,6 +2196,14 @@ VisMF::Read (FabArray<FArrayBox> &mf,
       }
     }
 
+    if(useMemoryMappedReads) {
+      for(int idx(0); idx < hdr.m_fod.size(); ++idx) {
+        std::string FullName(VisMF::DirName(mf_name));
+        FullName += hdr.m_fod[idx].m_name;
+        VisMF::UnmapFile(FullName);
+      }
+    }
+
     if(myProc == coordinatorProc && verbose) {
       auto mfReadTime = amrex::second() - startTime;
       totalTime += mfReadTime;
@@ -2201,6 +2450,211 @@ void VisMF::DeleteStream(const std::string &fileName)
 
 void VisMF::CloseAllStreams() {
   VisMF::persistentIFStreams.clear();
+  VisMF::mappedFiles.clear();
+}
+
+
+VisMF::MappedFile::MappedFile (const std::string& fileName)
+{
+#ifndef _WIN32
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return;
+    }
+    struct stat sb;
+    if(::fstat(fd, &sb) == 0 && sb.st_size > 0) {
+        // ---- private and writable so fabs aliasing the pages can be modified,
+        // ---- the changes never reach the file
+        void *p = ::mmap(nullptr, sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(p != MAP_FAILED) {
+            m_data = static_cast<char *>(p);
+            m_size = sb.st_size;
+        }
+    }
+    ::close(fd);
+#else
+    amrex::ignore_unused(fileName);
+#endif
+}
+
+
+VisMF::MappedFile::~MappedFile ()
+{
+#ifndef _WIN32
+    if(m_data != nullptr) {
+        ::munmap(m_data, m_size);
+    }
+#endif
+}
+
+
+std::shared_ptr<VisMF::MappedFile>
+VisMF::MapFile (const std::string &fileName)
+{
+    auto &mfile = VisMF::mappedFiles[fileName];
+    if( ! mfile) {
+        mfile = std::make_shared<MappedFile>(fileName);
+    }
+    if(mfile->data() == nullptr) {
+        VisMF::mappedFiles.erase(fileName);
+        return nullptr;
+    }
+    return mfile;
+}
+
+
+void
+VisMF::UnmapFile (const std::string &fileName)
+{
+    VisMF::mappedFiles.erase(fileName);
+}
+
+
+void
+VisMF::UnmapFiles (const std::string &filePrefix)
+{
+    auto it = VisMF::mappedFiles.lower_bound(filePrefix);
+    while(it != VisMF::mappedFiles.end() &&
+          it->first.compare(0, filePrefix.size(), filePrefix) == 0)
+    {
+        it = VisMF::mappedFiles.erase(it);
+    }
+}
+
+
+const char*
+VisMF::mappedFabData (const MappedFile &mfile, const Header &hdr,
+                      int idx, RealDescriptor &rd)
+{
+    const Long head(hdr.m_fod[idx].m_head);
+    if(head < 0 || head >= mfile.size()) {
+        return nullptr;
+    }
+    const char *p = mfile.data() + head;
+
+    if(hdr.m_vers == Header::Version_v1) {
+        // ---- parse the fab header in place, only the "new" FAB format is handled
+        MemoryBuf mbuf(p, mfile.size() - head);
+        std::istream is(&mbuf);
+        char f, a, b, c;
+        is >> f >> a >> b >> c;
+        if(f != 'F' || a != 'A' || b != 'B' || c == ':') {
+            return nullptr;
+        }
+        is.putback(c);
+        Box bx;
+        int nvar;
+        is >> rd >> bx >> nvar;
+        is.ignore(BL_IGNORE_MAX, '\n');
+        if(is.fail() || nvar != hdr.m_ncomp) {
+            return nullptr;
+        }
+        p += mbuf.consumed();
+    } else {
+        rd = hdr.m_writtenRD;
+    }
+
+    return p;
+}
+
+
+bool
+VisMF::readMappedFAB (const MappedFile &mfile, const Header &hdr,
+                      int idx, FArrayBox &fab, int whichComp)
+{
+    RealDescriptor rd;
+    const char *p = VisMF::mappedFabData(mfile, hdr, idx, rd);
+    if(p == nullptr) {
+        return false;
+    }
+    const Long remaining(mfile.data() + mfile.size() - p);
+    const Long npts(fab.box().numPts());
+
+    Real* fabdata = fab.dataPtr();
+#ifdef AMREX_USE_GPU
+    std::unique_ptr<FArrayBox> hostfab;
+    if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+        hostfab = std::make_unique<FArrayBox>(fab.box(), fab.nComp(), The_Pinned_Arena());
+        fabdata = hostfab->dataPtr();
+    }
+#endif
+
+    if(IsCompressed(hdr)) {
+        const Long nbytes(hdr.m_fabBytes[idx]);
+        if(remaining < nbytes) {
+            return false;
+        }
+        if(whichComp == -1) {
+            VisMFCompress::Decompress(p, nbytes, fabdata, npts * hdr.m_ncomp, rd);
+        } else {
+            FArrayBox allfab(fab.box(), hdr.m_ncomp, The_Pinned_Arena());
+            VisMFCompress::Decompress(p, nbytes, allfab.dataPtr(), npts * hdr.m_ncomp, rd);
+            std::memcpy(fabdata, allfab.dataPtr(whichComp), npts * sizeof(Real));
+        }
+    } else {
+        const Long nitems(npts * fab.nComp());
+        const Long skip((whichComp == -1) ? 0 : npts * whichComp * rd.numBytes());
+        if(remaining < skip + nitems * rd.numBytes()) {
+            return false;
+        }
+        if(rd == FPC::NativeRealDescriptor()) {
+            std::memcpy(fabdata, p + skip, nitems * sizeof(Real));
+        } else {
+            RealDescriptor::convertToNativeFormat(fabdata, nitems,
+                                                  const_cast<char *>(p + skip), rd);
+        }
+    }
+
+#ifdef AMREX_USE_GPU
+    if (hostfab) {
+        Gpu::htod_memcpy_async(fab.dataPtr(), hostfab->dataPtr(), fab.size()*sizeof(Real));
+        Gpu::streamSynchronize();
+    }
+#endif
+    return true;
+}
+
+
+FArrayBox*
+VisMF::mapFAB (int idx, int icomp)
+{
+    if(IsCompressed(m_hdr)) {
+        return nullptr;
+    }
+
+    std::string FullName(VisMF::DirName(m_fafabname));
+    FullName += m_hdr.m_fod[idx].m_name;
+
+    auto &mfile = m_mapped[FullName];
+    if( ! mfile) {
+        mfile = std::make_shared<MappedFile>(FullName);
+    }
+    if(mfile->data() == nullptr) {
+        return nullptr;
+    }
+
+    RealDescriptor rd;
+    const char *p = VisMF::mappedFabData(*mfile, m_hdr, idx, rd);
+    if(p == nullptr || rd != FPC::NativeRealDescriptor()) {
+        return nullptr;
+    }
+
+    Box fab_box(m_hdr.m_ba[idx]);
+    if(m_hdr.m_ngrow.max() > 0) {
+        fab_box.grow(m_hdr.m_ngrow);
+    }
+    const Long npts(fab_box.numPts());
+    const int ncomp((icomp == -1) ? m_hdr.m_ncomp : 1);
+    if(icomp > 0) {
+        p += npts * icomp * sizeof(Real);
+    }
+    if(p + npts * ncomp * sizeof(Real) > mfile->data() + mfile->size() ||
+       reinterpret_cast<std::uintptr_t>(p) % alignof(Real) != 0)
+    {
+        return nullptr;
+    }
+
+    return new FArrayBox(fab_box, ncomp, reinterpret_cast<Real const*>(p));
 }
 
 
@@ -2254,8 +2708,17 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 
     RealDescriptor const& whichRD = FPC::NativeRealDescriptor();
 
+    VisMF::UnmapFiles(mf_name + FabFileSuffix);
+
+    // ---- Compressed_v1 blocks are made here so their sizes can be gathered
+    const bool compressed = (currentVersion == VisMF::Header::Compressed_v1);
+    const auto compressRD = FArrayBox::getDataDescriptor();
+    const Real compressTol = compressionTolerance;
+    auto myblocks = std::make_shared<Vector<Vector<char> > >();
+
     auto hdr = std::make_shared<VisMF::Header>(mf, VisMF::NFiles, VisMF::Header::Version_v1, false);
     if (valid_cells_only) hdr->m_ngrow = IntVect(0);
+    if (compressed) hdr->m_vers = VisMF::Header::Compressed_v1;
 
     constexpr int sizeof_int64_over_real = sizeof(int64_t) / sizeof(Real);
     const int n_local_fabs = mf.local_size();
@@ -2284,12 +2747,31 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
             const FArrayBox& fab = mf[mfi];
             const Box& bx = mfi.validbox();
 
-            std::stringstream hss;
-            FArrayBox valid_fab(bx, ncomp, false);
-            FArrayBox const& header_fab = (strip_ghost) ? valid_fab : fab;
-            fio.write_header(hss, header_fab, ncomp);
-            total_bytes += static_cast<std::streamoff>(hss.tellp());
-            total_bytes += header_fab.size() * whichRD.numBytes();
+            if (compressed) {
+                FArrayBox hostfab;
+                FArrayBox const* srcfab = &fab;
+                if (strip_ghost || data_on_device) {
+                    hostfab.resize(strip_ghost ? bx : fab.box(), ncomp, The_Pinned_Arena());
+                    if (run_on_device) {
+                        hostfab.copy<RunOn::Device>(fab, hostfab.box());
+                        Gpu::streamSynchronize();
+                    } else {
+                        hostfab.copy<RunOn::Host>(fab, hostfab.box());
+                    }
+                    srcfab = &hostfab;
+                }
+                myblocks->emplace_back();
+                VisMFCompress::Compress(srcfab->dataPtr(), srcfab->size(), *compressRD,
+                                        compressTol, myblocks->back());
+                total_bytes += myblocks->back().size();
+            } else {
+                std::stringstream hss;
+                FArrayBox valid_fab(bx, ncomp, false);
+                FArrayBox const& header_fab = (strip_ghost) ? valid_fab : fab;
+                fio.write_header(hss, header_fab, ncomp);
+                total_bytes += static_cast<std::streamoff>(hss.tellp());
+                total_bytes += header_fab.size() * whichRD.numBytes();
+            }
 
             // compute min and max
             for (int icomp = 0; icomp < ncomp; ++icomp) {
@@ -2333,7 +2815,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 #endif
 
     auto myfabs = std::make_shared<Vector<FArrayBox> >();
-    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    for (MFIter mfi(mf); mfi.isValid() && ! compressed; ++mfi) {
         Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
 #ifdef AMREX_USE_GPU
         if (data_on_device) {
@@ -2424,6 +2906,19 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
                 }
             }
 
+            if (compressed) {
+                // ---- a block ends where the next one on the same rank starts
+                hdr->m_fabBytes.resize(n_global_fabs);
+                for (int ip = 0; ip < nprocs; ++ip) {
+                    for (int l = 0; l < gidx[ip].size(); ++l) {
+                        const int k = gidx[ip][l];
+                        const int64_t end = (l+1 < gidx[ip].size())
+                            ? hdr->m_fod[gidx[ip][l+1]].m_head : nbytes_on_rank[ip];
+                        hdr->m_fabBytes[k] = end - hdr->m_fod[k].m_head;
+                    }
+                }
+            }
+
             Vector<int64_t> offset(nprocs);
             for (int ip = 0; ip < nprocs; ++ip) {
                 auto info = AsyncOut::GetWriteInfo(ip);
@@ -2446,7 +2941,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
         AsyncOut::Wait();  // Wait for my turn
 
         auto info = AsyncOut::GetWriteInfo(myproc);
-        if (! myfabs->empty()) {
+        if (! myfabs->empty() || ! myblocks->empty()) {
             std::string file_name = amrex::Concatenate(mf_name + FabFileSuffix, info.ifile, 5);
             std::ofstream ofs;
             ofs.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
@@ -2457,6 +2952,9 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
                 fabio->write_header(ofs, fab, fab.nComp());
                 fabio->write(ofs, fab, 0, fab.nComp());
             }
+            for (auto const& block : *myblocks) {
+                ofs.write(block.data(), block.size());
+            }
             ofs.flush();
             ofs.close();
         }
@@ -0,0 +1,335 @@
+#include <AMReX_VisMFCompress.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Extension.H>
+#include <AMReX_FPC.H>
+#include <AMReX.H>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace amrex {
+namespace VisMFCompress {
+
+namespace
+{
+    constexpr int  MinMatch  = 4;
+    constexpr int  HashLog   = 16;
+    constexpr Long MaxOffset = 65535;
+
+    const char Magic[4] = {'V', 'M', 'F', 'C'};
+
+    void putU64 (unsigned char* p, std::uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i) {
+            p[i] = static_cast<unsigned char>(v >> (8*i));
+        }
+    }
+
+    std::uint64_t getU64 (const unsigned char* p)
+    {
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) {
+            v |= static_cast<std::uint64_t>(p[i]) << (8*i);
+        }
+        return v;
+    }
+
+    std::uint32_t read32 (const unsigned char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    unsigned int hash32 (std::uint32_t v)
+    {
+        return (v * 2654435761U) >> (32 - HashLog);
+    }
+
+    unsigned char* putLength (unsigned char* op, Long len)
+    {
+        while (len >= 255) {
+            *op++ = 255;
+            len -= 255;
+        }
+        *op++ = static_cast<unsigned char>(len);
+        return op;
+    }
+
+    bool getLength (const unsigned char*& ip, const unsigned char* iend, Long& len)
+    {
+        unsigned char c;
+        do {
+            if (ip >= iend) { return false; }
+            c = *ip++;
+            len += c;
+        } while (c == 255);
+        return true;
+    }
+
+    unsigned char* emitSequence (unsigned char* op, const unsigned char* lit, Long nlit,
+                                 Long offset, Long matchlen)
+    {
+        unsigned char* token = op++;
+        *token = 0;
+        if (nlit >= 15) {
+            *token = 15 << 4;
+            op = putLength(op, nlit - 15);
+        } else {
+            *token = static_cast<unsigned char>(nlit << 4);
+        }
+        std::memcpy(op, lit, nlit);
+        op += nlit;
+        if (matchlen > 0) {
+            *op++ = static_cast<unsigned char>(offset & 0xff);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+            Long ml = matchlen - MinMatch;
+            if (ml >= 15) {
+                *token |= 15;
+                op = putLength(op, ml - 15);
+            } else {
+                *token |= static_cast<unsigned char>(ml);
+            }
+        }
+        return op;
+    }
+
+    void writeHeader (unsigned char* p, Codec codec, int itemsize, Long nitems, double step)
+    {
+        std::memcpy(p, Magic, 4);
+        p[4] = codec;
+        p[5] = static_cast<unsigned char>(itemsize);
+        p[6] = p[7] = 0;
+        putU64(p+8, static_cast<std::uint64_t>(nitems));
+        std::uint64_t bits;
+        std::memcpy(&bits, &step, sizeof(bits));
+        putU64(p+16, bits);
+    }
+
+    void compressBytes (const unsigned char* src, Long nbytes, int itemsize,
+                        Codec codec, Long nitems, double step, Vector<char>& block)
+    {
+        Vector<unsigned char> shuffled(nbytes);
+        ByteShuffle(src, nbytes/itemsize, itemsize, shuffled.data());
+
+        block.resize(HeaderBytes + LZCompressBound(nbytes));
+        auto out = reinterpret_cast<unsigned char*>(block.data());
+        Long clen = LZCompress(shuffled.data(), nbytes, out + HeaderBytes);
+
+        if (codec == ShuffleLZ && clen >= nbytes) {
+            // ---- incompressible, store the bytes as they are
+            block.resize(HeaderBytes + nbytes);
+            out = reinterpret_cast<unsigned char*>(block.data());
+            writeHeader(out, Stored, itemsize, nitems, 0.0);
+            std::memcpy(out + HeaderBytes, src, nbytes);
+        } else {
+            block.resize(HeaderBytes + clen);
+            writeHeader(reinterpret_cast<unsigned char*>(block.data()),
+                        codec, itemsize, nitems, step);
+        }
+    }
+
+    bool quantize (const Real* data, Long nitems, double step, Vector<unsigned char>& bytes)
+    {
+        constexpr double qmax = 4.0e18;   // ---- well inside int64 for the deltas
+        bytes.resize(nitems*8);
+        std::int64_t prev = 0;
+        for (Long i = 0; i < nitems; ++i) {
+            double x = static_cast<double>(data[i]) / step;
+            if ( ! std::isfinite(x) || std::abs(x) > qmax/2) {
+                return false;
+            }
+            auto q = static_cast<std::int64_t>(std::llround(x));
+            std::int64_t d = q - prev;
+            prev = q;
+            auto z = (static_cast<std::uint64_t>(d) << 1) ^ static_cast<std::uint64_t>(d >> 63);
+            putU64(bytes.data() + 8*i, z);
+        }
+        return true;
+    }
+}
+
+void
+ByteShuffle (const unsigned char* src, Long nitems, int itemsize, unsigned char* dst)
+{
+    for (int b = 0; b < itemsize; ++b) {
+        unsigned char* AMREX_RESTRICT plane = dst + b*nitems;
+        const unsigned char* AMREX_RESTRICT s = src + b;
+        for (Long i = 0; i < nitems; ++i) {
+            plane[i] = s[i*itemsize];
+        }
+    }
+}
+
+void
+ByteUnshuffle (const unsigned char* src, Long nitems, int itemsize, unsigned char* dst)
+{
+    for (int b = 0; b < itemsize; ++b) {
+        const unsigned char* AMREX_RESTRICT plane = src + b*nitems;
+        unsigned char* AMREX_RESTRICT d = dst + b;
+        for (Long i = 0; i < nitems; ++i) {
+            d[i*itemsize] = plane[i];
+        }
+    }
+}
+
+Long
+LZCompressBound (Long n)
+{
+    return n + n/255 + 16;
+}
+
+Long
+LZCompress (const unsigned char* src, Long n, unsigned char* dst)
+{
+    Vector<Long> table(Long(1) << HashLog, -1);
+    unsigned char* op = dst;
+    Long anchor = 0;
+    Long ip = 0;
+
+    while (ip + MinMatch <= n) {
+        const std::uint32_t seq = read32(src + ip);
+        const unsigned int h = hash32(seq);
+        const Long ref = table[h];
+        table[h] = ip;
+        if (ref >= 0 && ip - ref <= MaxOffset && read32(src + ref) == seq) {
+            Long len = MinMatch;
+            while (ip + len < n && src[ref + len] == src[ip + len]) {
+                ++len;
+            }
+            op = emitSequence(op, src + anchor, ip - anchor, ip - ref, len);
+            ip += len;
+            anchor = ip;
+        } else {
+            ++ip;
+        }
+    }
+
+    // ---- the last sequence carries only literals
+    op = emitSequence(op, src + anchor, n - anchor, 0, 0);
+
+    return op - dst;
+}
+
+Long
+LZDecompress (const unsigned char* src, Long n, unsigned char* dst, Long dstcap)
+{
+    const unsigned char* ip   = src;
+    const unsigned char* iend = src + n;
+    Long op = 0;
+
+    while (ip < iend) {
+        const unsigned char token = *ip++;
+        Long nlit = token >> 4;
+        if (nlit == 15 && ! getLength(ip, iend, nlit)) { return -1; }
+        if (iend - ip < nlit || dstcap - op < nlit) { return -1; }
+        std::memcpy(dst + op, ip, nlit);
+        ip += nlit;
+        op += nlit;
+
+        if (ip == iend) { break; }
+
+        if (iend - ip < 2) { return -1; }
+        const Long offset = static_cast<Long>(ip[0]) | (static_cast<Long>(ip[1]) << 8);
+        ip += 2;
+        Long len = token & 15;
+        if (len == 15 && ! getLength(ip, iend, len)) { return -1; }
+        len += MinMatch;
+        if (offset == 0 || offset > op || dstcap - op < len) { return -1; }
+        // ---- matches may overlap their own output
+        for (Long i = 0; i < len; ++i, ++op) {
+            dst[op] = dst[op - offset];
+        }
+    }
+
+    return op;
+}
+
+void
+Compress (const Real* data, Long nitems, const RealDescriptor& rd,
+          Real tol, Vector<char>& block)
+{
+    if (tol > 0) {
+        const double step = 2.0 * static_cast<double>(tol);
+        Vector<unsigned char> qbytes;
+        if (quantize(data, nitems, step, qbytes)) {
+            compressBytes(qbytes.data(), nitems*8, 8, QuantizeLZ, nitems, step, block);
+            return;
+        }
+    }
+
+    const int itemsize = rd.numBytes();
+    const Long nbytes = nitems * itemsize;
+    if (rd == FPC::NativeRealDescriptor()) {
+        compressBytes(reinterpret_cast<const unsigned char*>(data), nbytes, itemsize,
+                      ShuffleLZ, nitems, 0.0, block);
+    } else {
+        Vector<unsigned char> converted(nbytes);
+        RealDescriptor::convertFromNativeFormat(converted.data(), nitems, data, rd);
+        compressBytes(converted.data(), nbytes, itemsize, ShuffleLZ, nitems, 0.0, block);
+    }
+}
+
+void
+Decompress (const char* block, Long nbytes, Real* data, Long nitems,
+            const RealDescriptor& rd)
+{
+    auto in = reinterpret_cast<const unsigned char*>(block);
+    if (nbytes < HeaderBytes || std::memcmp(in, Magic, 4) != 0) {
+        amrex::Error("VisMFCompress::Decompress: bad block header");
+    }
+
+    const auto codec    = static_cast<Codec>(in[4]);
+    const int  itemsize = in[5];
+    const auto nstored  = static_cast<Long>(getU64(in+8));
+    const std::uint64_t stepbits = getU64(in+16);
+    double step;
+    std::memcpy(&step, &stepbits, sizeof(step));
+
+    if (nstored != nitems) {
+        amrex::Error("VisMFCompress::Decompress: block size does not match FAB size");
+    }
+
+    const unsigned char* payload = in + HeaderBytes;
+    const Long npayload = nbytes - HeaderBytes;
+    const Long rawbytes = nitems * itemsize;
+
+    Vector<unsigned char> raw;
+    if (codec == Stored) {
+        if (npayload != rawbytes) {
+            amrex::Error("VisMFCompress::Decompress: bad stored block");
+        }
+    } else if (codec == ShuffleLZ || codec == QuantizeLZ) {
+        Vector<unsigned char> shuffled(rawbytes);
+        if (LZDecompress(payload, npayload, shuffled.data(), rawbytes) != rawbytes) {
+            amrex::Error("VisMFCompress::Decompress: corrupt block");
+        }
+        raw.resize(rawbytes);
+        ByteUnshuffle(shuffled.data(), nitems, itemsize, raw.data());
+        payload = raw.data();
+    } else {
+        amrex::Error("VisMFCompress::Decompress: unknown codec");
+    }
+
+    if (codec == QuantizeLZ) {
+        BL_ASSERT(itemsize == 8);
+        std::int64_t q = 0;
+        for (Long i = 0; i < nitems; ++i) {
+            const std::uint64_t z = getU64(payload + 8*i);
+            const auto d = static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+            q += d;
+            data[i] = static_cast<Real>(static_cast<double>(q) * step);
+        }
+    } else if (rd == FPC::NativeRealDescriptor()) {
+        BL_ASSERT(itemsize == static_cast<int>(sizeof(Real)));
+        std::memcpy(data, payload, rawbytes);
+    } else {
+        RealDescriptor::convertToNativeFormat(data, nitems,
+                                              const_cast<unsigned char*>(payload), rd);
+    }
+}
+
+}
+}
@@ -97,6 +97,12 @@ int
 Parser::maxStackSize () const
 {
     if (m_data && m_data->m_parser) {
+        if (!(m_data->m_host_executor)) {
+            // not compiled yet
+            int max_stack_size, stack_size;
+            parser_exe_size(m_data->m_parser, max_stack_size, stack_size);
+            return max_stack_size;
+        }
         return m_data->m_max_stack_size;
     } else {
         return 0;
@@ -113,6 +119,36 @@ Parser::expr () const
     }
 }
 
+void
+Parser::eliminateCommonSubexpressions () const
+{
+    struct amrex_parser* cse_parser = parser_cse(m_data->m_parser);
+    if (cse_parser) {
+        // Each common subexpression takes a slot on the stack.
+        int max_stack_size, stack_size;
+        parser_exe_size(cse_parser, max_stack_size, stack_size);
+        if (max_stack_size <= AMREX_PARSER_STACK_SIZE) {
+            amrex_parser_delete(m_data->m_parser);
+            m_data->m_parser = cse_parser;
+        } else {
+            amrex_parser_delete(cse_parser);
+        }
+    }
+}
+
+Parser
+Parser::derivative (std::string const& var) const
+{
+    Parser r;
+    r.m_data = std::make_shared<Data>();
+    if (m_data && m_data->m_parser) {
+        r.m_data->m_expression = "d(" + m_data->m_expression + ")/d" + var;
+        r.m_data->m_parser = parser_derivative(m_data->m_parser, var.c_str());
+        r.m_data->m_nvars = m_data->m_nvars;
+    }
+    return r;
+}
+
 std::set<std::string>
 Parser::symbols () const
 {
@@ -722,4 +722,402 @@ parser_compile_exe_size (struct parser_node* node, char*& p, std::size_t& exe_si
     }
 }
 
+namespace {
+
+void parser_call_f1_batch (enum parser_f1_t type, int n, double* a)
+{
+    switch (type) {
+    case PARSER_SQRT:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = std::sqrt(a[k]); }
+        break;
+    case PARSER_ABS:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = amrex::Math::abs(a[k]); }
+        break;
+    case PARSER_POW_M3:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = 1.0/(a[k]*a[k]*a[k]); }
+        break;
+    case PARSER_POW_M2:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = 1.0/(a[k]*a[k]); }
+        break;
+    case PARSER_POW_M1:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = 1.0/a[k]; }
+        break;
+    case PARSER_POW_P1:
+        break;
+    case PARSER_POW_P2:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = a[k]*a[k]; }
+        break;
+    case PARSER_POW_P3:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { a[k] = a[k]*a[k]*a[k]; }
+        break;
+    default:
+        for (int k = 0; k < n; ++k) { a[k] = parser_call_f1(type, a[k]); }
+    }
+}
+
+// c may be the same as a or b
+void parser_call_f2_batch (enum parser_f2_t type, int n, double const* a, double const* b,
+                           double* c)
+{
+    switch (type) {
+    case PARSER_GT:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { c[k] = (a[k] > b[k]) ? 1.0 : 0.0; }
+        break;
+    case PARSER_LT:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { c[k] = (a[k] < b[k]) ? 1.0 : 0.0; }
+        break;
+    case PARSER_GEQ:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { c[k] = (a[k] >= b[k]) ? 1.0 : 0.0; }
+        break;
+    case PARSER_LEQ:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { c[k] = (a[k] <= b[k]) ? 1.0 : 0.0; }
+        break;
+    case PARSER_MIN:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { c[k] = (a[k] < b[k]) ? a[k] : b[k]; }
+        break;
+    case PARSER_MAX:
+        AMREX_PRAGMA_SIMD
+        for (int k = 0; k < n; ++k) { c[k] = (a[k] > b[k]) ? a[k] : b[k]; }
+        break;
+    default:
+        for (int k = 0; k < n; ++k) { c[k] = parser_call_f2(type, a[k], b[k]); }
+    }
+}
+
+}
+
+void
+parser_exe_eval_batch (char* p0, int nvars, int npts, double const* const* x, double* r)
+{
+    constexpr int B = AMREX_PARSER_BATCH_SIZE;
+    double pstack[AMREX_PARSER_STACK_SIZE][B];
+    Vector<double> xpt(nvars);
+
+    for (int ib = 0; ib < npts; ib += B)
+    {
+        const int n = std::min(B, npts-ib);
+        auto get_data = [&] (int i) -> double const* {
+            return (i >= AMREX_PARSER_LOCAL_IDX0) ? pstack[i-AMREX_PARSER_LOCAL_IDX0] : x[i]+ib;
+        };
+
+        int sp = 0;
+        bool diverged = false;
+        char* p = p0;
+        while (*((parser_exe_t*)p) != PARSER_EXE_NULL && !diverged) {
+            switch (*((parser_exe_t*)p))
+            {
+            case PARSER_EXE_NUMBER:
+            {
+                double v = ((ParserExeNumber*)p)->v;
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = v; }
+                p += sizeof(ParserExeNumber);
+                break;
+            }
+            case PARSER_EXE_SYMBOL:
+            {
+                double const* d = get_data(((ParserExeSymbol*)p)->i);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = d[k]; }
+                p += sizeof(ParserExeSymbol);
+                break;
+            }
+            case PARSER_EXE_ADD:
+            {
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] += b[k]; }
+                p += sizeof(ParserExeADD);
+                break;
+            }
+            case PARSER_EXE_SUB:
+            {
+                double sign = ((ParserExeSUB*)p)->sign;
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] = (a[k] - b[k]) * sign; }
+                p += sizeof(ParserExeSUB);
+                break;
+            }
+            case PARSER_EXE_MUL:
+            {
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] *= b[k]; }
+                p += sizeof(ParserExeMUL);
+                break;
+            }
+            case PARSER_EXE_DIV_F:
+            {
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] /= b[k]; }
+                p += sizeof(ParserExeDIV_F);
+                break;
+            }
+            case PARSER_EXE_DIV_B:
+            {
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] = b[k] / a[k]; }
+                p += sizeof(ParserExeDIV_B);
+                break;
+            }
+            case PARSER_EXE_NEG:
+            {
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] = -a[k]; }
+                p += sizeof(ParserExeNEG);
+                break;
+            }
+            case PARSER_EXE_F1:
+            {
+                parser_call_f1_batch(((ParserExeF1*)p)->ftype, n, pstack[sp-1]);
+                p += sizeof(ParserExeF1);
+                break;
+            }
+            case PARSER_EXE_F2_F:
+            {
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                parser_call_f2_batch(((ParserExeF2_F*)p)->ftype, n, a, b, a);
+                p += sizeof(ParserExeF2_F);
+                break;
+            }
+            case PARSER_EXE_F2_B:
+            {
+                double const* b = pstack[--sp];
+                double* a = pstack[sp-1];
+                parser_call_f2_batch(((ParserExeF2_B*)p)->ftype, n, b, a, a);
+                p += sizeof(ParserExeF2_B);
+                break;
+            }
+            case PARSER_EXE_ADD_VP:
+            {
+                double v = ((ParserExeADD_VP*)p)->v;
+                double const* d = get_data(((ParserExeADD_VP*)p)->i);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = v + d[k]; }
+                p += sizeof(ParserExeADD_VP);
+                break;
+            }
+            case PARSER_EXE_SUB_VP:
+            {
+                double v = ((ParserExeSUB_VP*)p)->v;
+                double const* d = get_data(((ParserExeSUB_VP*)p)->i);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = v - d[k]; }
+                p += sizeof(ParserExeSUB_VP);
+                break;
+            }
+            case PARSER_EXE_MUL_VP:
+            {
+                double v = ((ParserExeMUL_VP*)p)->v;
+                double const* d = get_data(((ParserExeMUL_VP*)p)->i);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = v * d[k]; }
+                p += sizeof(ParserExeMUL_VP);
+                break;
+            }
+            case PARSER_EXE_DIV_VP:
+            {
+                double v = ((ParserExeDIV_VP*)p)->v;
+                double const* d = get_data(((ParserExeDIV_VP*)p)->i);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = v / d[k]; }
+                p += sizeof(ParserExeDIV_VP);
+                break;
+            }
+            case PARSER_EXE_ADD_PP:
+            {
+                double const* d1 = get_data(((ParserExeADD_PP*)p)->i1);
+                double const* d2 = get_data(((ParserExeADD_PP*)p)->i2);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = d1[k] + d2[k]; }
+                p += sizeof(ParserExeADD_PP);
+                break;
+            }
+            case PARSER_EXE_SUB_PP:
+            {
+                double const* d1 = get_data(((ParserExeSUB_PP*)p)->i1);
+                double const* d2 = get_data(((ParserExeSUB_PP*)p)->i2);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = d1[k] - d2[k]; }
+                p += sizeof(ParserExeSUB_PP);
+                break;
+            }
+            case PARSER_EXE_MUL_PP:
+            {
+                double const* d1 = get_data(((ParserExeMUL_PP*)p)->i1);
+                double const* d2 = get_data(((ParserExeMUL_PP*)p)->i2);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = d1[k] * d2[k]; }
+                p += sizeof(ParserExeMUL_PP);
+                break;
+            }
+            case PARSER_EXE_DIV_PP:
+            {
+                double const* d1 = get_data(((ParserExeDIV_PP*)p)->i1);
+                double const* d2 = get_data(((ParserExeDIV_PP*)p)->i2);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = d1[k] / d2[k]; }
+                p += sizeof(ParserExeDIV_PP);
+                break;
+            }
+            case PARSER_EXE_NEG_P:
+            {
+                double const* d = get_data(((ParserExeNEG_P*)p)->i);
+                double* t = pstack[sp++];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { t[k] = -d[k]; }
+                p += sizeof(ParserExeNEG_P);
+                break;
+            }
+            case PARSER_EXE_ADD_VN:
+            {
+                double v = ((ParserExeADD_VN*)p)->v;
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] += v; }
+                p += sizeof(ParserExeADD_VN);
+                break;
+            }
+            case PARSER_EXE_SUB_VN:
+            {
+                double v = ((ParserExeSUB_VN*)p)->v;
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] = v - a[k]; }
+                p += sizeof(ParserExeSUB_VN);
+                break;
+            }
+            case PARSER_EXE_MUL_VN:
+            {
+                double v = ((ParserExeMUL_VN*)p)->v;
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] *= v; }
+                p += sizeof(ParserExeMUL_VN);
+                break;
+            }
+            case PARSER_EXE_DIV_VN:
+            {
+                double v = ((ParserExeDIV_VN*)p)->v;
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] = v / a[k]; }
+                p += sizeof(ParserExeDIV_VN);
+                break;
+            }
+            case PARSER_EXE_ADD_PN:
+            {
+                double const* d = get_data(((ParserExeADD_PN*)p)->i);
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] += d[k]; }
+                p += sizeof(ParserExeADD_PN);
+                break;
+            }
+            case PARSER_EXE_SUB_PN:
+            {
+                double sign = ((ParserExeSUB_PN*)p)->sign;
+                double const* d = get_data(((ParserExeSUB_PN*)p)->i);
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] = (d[k] - a[k]) * sign; }
+                p += sizeof(ParserExeSUB_PN);
+                break;
+            }
+            case PARSER_EXE_MUL_PN:
+            {
+                double const* d = get_data(((ParserExeMUL_PN*)p)->i);
+                double* a = pstack[sp-1];
+                AMREX_PRAGMA_SIMD
+                for (int k = 0; k < n; ++k) { a[k] *= d[k]; }
+                p += sizeof(ParserExeMUL_PN);
+                break;
+            }
+            case PARSER_EXE_DIV_PN:
+            {
+                double const* d = get_data(((ParserExeDIV_PN*)p)->i);
+                double* a = pstack[sp-1];
+                if (((ParserExeDIV_PN*)p)->reverse) {
+                    AMREX_PRAGMA_SIMD
+                    for (int k = 0; k < n; ++k) { a[k] /= d[k]; }
+                } else {
+                    AMREX_PRAGMA_SIMD
+                    for (int k = 0; k < n; ++k) { a[k] = d[k] / a[k]; }
+                }
+                p += sizeof(ParserExeDIV_PN);
+                break;
+            }
+            case PARSER_EXE_IF:
+            {
+                // Branches are followed only if all points in the batch agree.
+                // Otherwise the batch is evaluated point by point.
+                double const* cond = pstack[--sp];
+                int ntrue = 0;
+                for (int k = 0; k < n; ++k) { ntrue += (cond[k] != 0.0); }
+                if (ntrue == 0) {
+                    p += ((ParserExeIF*)p)->offset;
+                } else if (ntrue != n) {
+                    diverged = true;
+                }
+                p += sizeof(ParserExeIF);
+                break;
+            }
+            case PARSER_EXE_JUMP:
+            {
+                int offset = ((ParserExeJUMP*)p)->offset;
+                p += sizeof(ParserExeJUMP) + offset;
+                break;
+            }
+            default:
+                amrex::Abort("parser_exe_eval_batch: unknown node type");
+            }
+        }
+
+        if (diverged) {
+            for (int k = 0; k < n; ++k) {
+                for (int j = 0; j < nvars; ++j) {
+                    xpt[j] = x[j][ib+k];
+                }
+                r[ib+k] = parser_exe_eval(p0, xpt.data());
+            }
+        } else {
+            double const* t = pstack[sp-1];
+            AMREX_PRAGMA_SIMD
+            for (int k = 0; k < n; ++k) { r[ib+k] = t[k]; }
+        }
+    }
+}
+
 }
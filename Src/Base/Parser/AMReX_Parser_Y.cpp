@@ -3,8 +3,12 @@
 #include <amrex_parser.tab.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstdarg>
+#include <cstdio>
+#include <map>
 #include <string>
+#include <vector>
 
 void
 amrex_parsererror (char const *s, ...)
@@ -351,6 +355,23 @@ parser_ast_dup (struct amrex_parser* my_parser, struct parser_node* node, int mo
     return (struct parser_node*)result;
 }
 
+// Size of the struct of a single node, not including its children
+static
+std::size_t
+parser_node_size (struct parser_node* node)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER: return sizeof(struct parser_number);
+    case PARSER_SYMBOL: return sizeof(struct parser_symbol);
+    case PARSER_F1:     return sizeof(struct parser_f1);
+    case PARSER_F2:     return sizeof(struct parser_f2);
+    case PARSER_F3:     return sizeof(struct parser_f3);
+    case PARSER_ASSIGN: return sizeof(struct parser_assign);
+    default:            return sizeof(struct parser_node);
+    }
+}
+
 #define PARSER_MOVEUP_R(node, v) \
     struct parser_node* n = node->r->r; \
     int ip = node->r->rip; \
@@ -1120,6 +1141,13 @@ parser_ast_optimize (struct parser_node* node)
             ((struct parser_number*)node)->type = PARSER_NUMBER;
             ((struct parser_number*)node)->value = v;
         }
+        else if (((struct parser_f3*)node)->n1->type == PARSER_NUMBER)
+        { // if(#, node_2, node_3) -> node_2 or node_3
+            struct parser_node* n =
+                (((struct parser_number*)(((struct parser_f3*)node)->n1))->value != 0.0)
+                ? ((struct parser_f3*)node)->n2 : ((struct parser_f3*)node)->n3;
+            std::memcpy((void*)node, n, parser_node_size(n));
+        }
         break;
     case PARSER_ADD_VP:
         parser_ast_optimize(node->r);
@@ -1605,6 +1633,572 @@ void parser_ast_get_symbols (struct parser_node* node, std::set<std::string>& sy
     }
 }
 
+namespace {
+
+struct ParserCSE
+{
+    int count = 0;  // number of occurrences
+    int uncond = 0; // number of occurrences evaluated unconditionally
+    int cost = 0;
+    std::vector<struct parser_node**> sites;
+};
+
+std::string
+parser_cse_number_key (double v)
+{
+    char buf[64];
+    std::snprintf(buf, 64, "%a", v);
+    return std::string(buf);
+}
+
+std::string
+parser_cse_symbol_key (struct parser_node* node)
+{
+    return std::string("$") + ((struct parser_symbol*)node)->name;
+}
+
+// Returns a key that is the same for identical subtrees, and records in m
+// the subtrees that are expensive enough to be worth computing only once.
+// ok is set to false for nodes that cannot be moved, i.e., assignments.
+std::string
+parser_cse_key (struct parser_node** site, bool uncond, bool root,
+                std::map<std::string,ParserCSE>& m, int& cost, bool& ok)
+{
+    struct parser_node* node = *site;
+    std::string key;
+    int c1 = 0, c2 = 0, c3 = 0;
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+        cost = 0;
+        return parser_cse_number_key(((struct parser_number*)node)->value);
+    case PARSER_SYMBOL:
+        cost = 0;
+        return parser_cse_symbol_key(node);
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+        key = "(" + std::to_string(node->type) + " "
+            + parser_cse_key(&(node->l), uncond, false, m, c1, ok) + " "
+            + parser_cse_key(&(node->r), uncond, false, m, c2, ok) + ")";
+        cost = 1 + c1 + c2;
+        break;
+    case PARSER_NEG:
+        key = "(" + std::to_string(node->type) + " "
+            + parser_cse_key(&(node->l), uncond, false, m, c1, ok) + ")";
+        cost = 1 + c1;
+        break;
+    case PARSER_F1:
+        key = "(f1 " + std::to_string(((struct parser_f1*)node)->ftype) + " "
+            + parser_cse_key(&(((struct parser_f1*)node)->l), uncond, false, m, c1, ok) + ")";
+        cost = 2 + c1;
+        break;
+    case PARSER_F2:
+        key = "(f2 " + std::to_string(((struct parser_f2*)node)->ftype) + " "
+            + parser_cse_key(&(((struct parser_f2*)node)->l), uncond, false, m, c1, ok) + " "
+            + parser_cse_key(&(((struct parser_f2*)node)->r), uncond, false, m, c2, ok) + ")";
+        cost = 2 + c1 + c2;
+        break;
+    case PARSER_F3:
+        // Only the condition is always evaluated
+        key = "(f3 " + std::to_string(((struct parser_f3*)node)->ftype) + " "
+            + parser_cse_key(&(((struct parser_f3*)node)->n1), uncond, false, m, c1, ok) + " "
+            + parser_cse_key(&(((struct parser_f3*)node)->n2), false, false, m, c2, ok) + " "
+            + parser_cse_key(&(((struct parser_f3*)node)->n3), false, false, m, c3, ok) + ")";
+        cost = 2 + c1 + c2 + c3;
+        break;
+    case PARSER_ADD_VP:
+    case PARSER_SUB_VP:
+    case PARSER_MUL_VP:
+    case PARSER_DIV_VP:
+        key = "(" + std::to_string(node->type) + " " + parser_cse_number_key(node->lvp.v)
+            + " " + parser_cse_symbol_key(node->r) + ")";
+        cost = 1;
+        break;
+    case PARSER_ADD_PP:
+    case PARSER_SUB_PP:
+    case PARSER_MUL_PP:
+    case PARSER_DIV_PP:
+        key = "(" + std::to_string(node->type) + " " + parser_cse_symbol_key(node->l)
+            + " " + parser_cse_symbol_key(node->r) + ")";
+        cost = 1;
+        break;
+    case PARSER_NEG_P:
+        key = "(" + std::to_string(node->type) + " " + parser_cse_symbol_key(node->l) + ")";
+        cost = 1;
+        break;
+    default:
+        ok = false;
+        cost = 0;
+        return key;
+    }
+
+    if (cost >= 2 && !root) {
+        auto& cse = m[key];
+        ++cse.count;
+        if (uncond) { ++cse.uncond; }
+        cse.cost = cost;
+        cse.sites.push_back(site);
+    }
+    return key;
+}
+
+}
+
+struct amrex_parser*
+parser_cse (struct amrex_parser* parser)
+{
+    // We work on a copy, in which the common subexpressions are replaced
+    // with std::malloc'ed nodes, and then copy it into a new memory pool.
+    struct amrex_parser* work = parser_dup(parser);
+
+    // Only the final expression, which follows all the assignments, is
+    // searched.  The new local variables are assigned right before it.
+    struct parser_node** body = &(work->ast);
+    while ((*body)->type == PARSER_LIST) {
+        body = &((*body)->r);
+    }
+
+    std::vector<struct parser_node*> temps; // assignments in the order of evaluation
+    std::vector<void*> new_nodes;
+    bool changed = false;
+
+    // Reuse the local variables assigned by the user, unless they or the
+    // symbols in their values are assigned again later.
+    std::vector<struct parser_assign*> assigns;
+    {
+        std::vector<struct parser_node*> nodes{work->ast};
+        while (!nodes.empty()) {
+            struct parser_node* node = nodes.back();
+            nodes.pop_back();
+            if (node->type == PARSER_LIST) {
+                nodes.push_back(node->r);
+                nodes.push_back(node->l);
+            } else if (node->type == PARSER_ASSIGN) {
+                assigns.push_back((struct parser_assign*)node);
+            }
+        }
+    }
+    std::set<std::string> local_names;
+    for (auto* asgn : assigns) {
+        local_names.emplace(asgn->s->name);
+    }
+    int icse = 0;
+
+    for (int i = 0, n = static_cast<int>(assigns.size()); i < n; ++i)
+    {
+        std::set<std::string> symbols, local_symbols;
+        parser_ast_get_symbols(assigns[i]->v, symbols, local_symbols);
+        symbols.emplace(assigns[i]->s->name);
+        bool reassigned = !local_symbols.empty();
+        for (int j = i+1; j < n; ++j) {
+            reassigned = reassigned || symbols.count(assigns[j]->s->name);
+        }
+        if (reassigned) { continue; }
+
+        std::map<std::string,ParserCSE> m;
+        bool ok = true;
+        int cost;
+        parser_cse_key(body, true, false, m, cost, ok);
+        std::map<std::string,ParserCSE> mv;
+        std::string key = parser_cse_key(&(assigns[i]->v), true, false, mv, cost, ok);
+        auto found = m.find(key);
+        if (ok && found != m.end()) {
+            struct parser_symbol* sym = parser_makesymbol(assigns[i]->s->name);
+            new_nodes.push_back(sym->name);
+            new_nodes.push_back(sym);
+            for (auto* site : found->second.sites) {
+                *site = (struct parser_node*)sym;
+            }
+            changed = true;
+        }
+    }
+
+    while (true)
+    {
+        std::map<std::string,ParserCSE> m;
+        bool ok = true;
+        int cost;
+        parser_cse_key(body, true, true, m, cost, ok);
+        for (auto* t : temps) {
+            parser_cse_key(&(((struct parser_assign*)t)->v), true, true, m, cost, ok);
+        }
+        if (!ok) { break; }
+
+        // The most expensive one first.  It cannot be part of a cheaper one
+        // found later, which therefore can be evaluated before it.
+        auto best = m.end();
+        for (auto it = m.begin(); it != m.end(); ++it) {
+            if (it->second.count >= 2 && it->second.uncond >= 1 &&
+                (best == m.end() || it->second.cost > best->second.cost)) {
+                best = it;
+            }
+        }
+        if (best == m.end()) { break; }
+
+        std::string name;
+        do {
+            name = "@cse" + std::to_string(icse++);
+        } while (local_names.count(name));
+        struct parser_symbol* sym = parser_makesymbol(&name[0]);
+        new_nodes.push_back(sym->name);
+        new_nodes.push_back(sym);
+        struct parser_node* value = *(best->second.sites[0]);
+        for (auto* site : best->second.sites) {
+            *site = (struct parser_node*)sym;
+        }
+        temps.insert(temps.begin(), parser_newassign(sym, value));
+        new_nodes.push_back(temps.front());
+    }
+
+    struct amrex_parser* result = nullptr;
+    if (!temps.empty())
+    {
+        struct parser_node* list = temps[0];
+        for (int i = 1, n = static_cast<int>(temps.size()); i < n; ++i) {
+            list = parser_newlist(list, temps[i]);
+            new_nodes.push_back(list);
+        }
+        *body = parser_newlist(list, *body);
+        new_nodes.push_back(*body);
+        changed = true;
+    }
+
+    if (changed)
+    {
+
+        result = (struct amrex_parser*) std::malloc(sizeof(struct amrex_parser));
+        result->sz_mempool = parser_ast_size(work->ast);
+        result->p_root = std::malloc(result->sz_mempool);
+        result->p_free = result->p_root;
+        result->ast = parser_ast_dup(result, work->ast, 0);
+        parser_ast_optimize(result->ast);
+    }
+
+    for (auto* p : new_nodes) {
+        std::free(p);
+    }
+    amrex_parser_delete(work);
+    return result;
+}
+
+namespace {
+
+// Derivative of a parser AST.  New nodes are std::malloc'ed, and they may
+// point to the nodes of the original AST.  nullptr stands for zero.
+struct ParserDerivative
+{
+    std::string var;
+    // derivatives of local variables
+    std::map<std::string,struct parser_node*> local_d;
+    std::vector<void*> new_nodes;
+
+    struct parser_node* track (struct parser_node* node) {
+        new_nodes.push_back(node);
+        return node;
+    }
+
+    struct parser_node* number (double v) {
+        return track(parser_newnumber(v));
+    }
+
+    struct parser_node* symbol (std::string const& name) {
+        std::string tmp = name;
+        struct parser_symbol* sym = parser_makesymbol(&tmp[0]);
+        new_nodes.push_back(sym->name);
+        return track((struct parser_node*)sym);
+    }
+
+    struct parser_node* node (enum parser_node_t type, struct parser_node* l,
+                              struct parser_node* r) {
+        return track(parser_newnode(type, l, r));
+    }
+
+    struct parser_node* f1 (enum parser_f1_t ftype, struct parser_node* l) {
+        return track(parser_newf1(ftype, l));
+    }
+
+    struct parser_node* f2 (enum parser_f2_t ftype, struct parser_node* l,
+                            struct parser_node* r) {
+        return track(parser_newf2(ftype, l, r));
+    }
+
+    struct parser_node* add (struct parser_node* a, struct parser_node* b) {
+        if (a == nullptr) { return b; }
+        if (b == nullptr) { return a; }
+        return node(PARSER_ADD, a, b);
+    }
+
+    struct parser_node* sub (struct parser_node* a, struct parser_node* b) {
+        if (b == nullptr) { return a; }
+        if (a == nullptr) { return node(PARSER_NEG, b, nullptr); }
+        return node(PARSER_SUB, a, b);
+    }
+
+    static bool is_one (struct parser_node* n) {
+        return n->type == PARSER_NUMBER && ((struct parser_number*)n)->value == 1.0;
+    }
+
+    // f * db, where f is not zero
+    struct parser_node* mul (struct parser_node* f, struct parser_node* db) {
+        if (db == nullptr) { return nullptr; }
+        if (is_one(db)) { return f; }
+        if (is_one(f)) { return db; }
+        return node(PARSER_MUL, f, db);
+    }
+
+    struct parser_node* d_symbol (struct parser_node* sym) {
+        std::string name(((struct parser_symbol*)sym)->name);
+        auto found = local_d.find(name);
+        if (found != local_d.end()) {
+            return found->second;
+        } else if (name == var) {
+            return number(1.0);
+        } else {
+            return nullptr;
+        }
+    }
+
+    struct parser_node* d (struct parser_node* n);
+    struct parser_node* d_f1 (struct parser_f1* n);
+    struct parser_node* d_f2 (struct parser_f2* n);
+};
+
+struct parser_node*
+ParserDerivative::d (struct parser_node* n)
+{
+    switch (n->type)
+    {
+    case PARSER_NUMBER:
+        return nullptr;
+    case PARSER_SYMBOL:
+        return d_symbol(n);
+    case PARSER_ADD:
+        return add(d(n->l), d(n->r));
+    case PARSER_SUB:
+        return sub(d(n->l), d(n->r));
+    case PARSER_MUL:
+        return add(mul(n->r, d(n->l)), mul(n->l, d(n->r)));
+    case PARSER_DIV:
+    { // (dl - (l/r)*dr) / r
+        struct parser_node* dd = sub(d(n->l), mul(n, d(n->r)));
+        return (dd) ? node(PARSER_DIV, dd, n->r) : nullptr;
+    }
+    case PARSER_NEG:
+        return sub(nullptr, d(n->l));
+    case PARSER_F1:
+        return d_f1((struct parser_f1*)n);
+    case PARSER_F2:
+        return d_f2((struct parser_f2*)n);
+    case PARSER_F3:
+    {
+        auto f3 = (struct parser_f3*)n;
+        struct parser_node* d2 = d(f3->n2);
+        struct parser_node* d3 = d(f3->n3);
+        if (d2 == nullptr && d3 == nullptr) { return nullptr; }
+        return track(parser_newf3(f3->ftype, f3->n1, (d2) ? d2 : number(0.0),
+                                  (d3) ? d3 : number(0.0)));
+    }
+    case PARSER_ADD_VP:
+        return d_symbol(n->r);
+    case PARSER_SUB_VP:
+        return sub(nullptr, d_symbol(n->r));
+    case PARSER_MUL_VP:
+        return mul(number(n->lvp.v), d_symbol(n->r));
+    case PARSER_DIV_VP: // -(v/r)/r * dr
+        return mul(node(PARSER_DIV, node(PARSER_NEG, n, nullptr), n->r), d_symbol(n->r));
+    case PARSER_ADD_PP:
+        return add(d_symbol(n->l), d_symbol(n->r));
+    case PARSER_SUB_PP:
+        return sub(d_symbol(n->l), d_symbol(n->r));
+    case PARSER_MUL_PP:
+        return add(mul(n->r, d_symbol(n->l)), mul(n->l, d_symbol(n->r)));
+    case PARSER_DIV_PP:
+    {
+        struct parser_node* dd = sub(d_symbol(n->l), mul(n, d_symbol(n->r)));
+        return (dd) ? node(PARSER_DIV, dd, n->r) : nullptr;
+    }
+    case PARSER_NEG_P:
+        return sub(nullptr, d_symbol(n->l));
+    default:
+        amrex::Abort("parser_derivative: unknown node type " + std::to_string(n->type));
+        return nullptr;
+    }
+}
+
+struct parser_node*
+ParserDerivative::d_f1 (struct parser_f1* n)
+{
+    struct parser_node* u = n->l;
+    struct parser_node* du = d(u);
+    if (du == nullptr) { return nullptr; }
+    switch (n->ftype)
+    {
+    case PARSER_SQRT:
+        return mul(node(PARSER_DIV, number(0.5), (struct parser_node*)n), du);
+    case PARSER_EXP:
+        return mul((struct parser_node*)n, du);
+    case PARSER_LOG:
+        return node(PARSER_DIV, du, u);
+    case PARSER_LOG10:
+        return node(PARSER_DIV, du, node(PARSER_MUL, number(std::log(10.0)), u));
+    case PARSER_SIN:
+        return mul(f1(PARSER_COS, u), du);
+    case PARSER_COS:
+        return mul(node(PARSER_NEG, f1(PARSER_SIN, u), nullptr), du);
+    case PARSER_TAN:
+        return mul(f1(PARSER_POW_M2, f1(PARSER_COS, u)), du);
+    case PARSER_ASIN:
+        return node(PARSER_DIV, du, f1(PARSER_SQRT, node(PARSER_SUB, number(1.0),
+                                                          f1(PARSER_POW_P2, u))));
+    case PARSER_ACOS:
+        return node(PARSER_DIV, node(PARSER_NEG, du, nullptr),
+                    f1(PARSER_SQRT, node(PARSER_SUB, number(1.0), f1(PARSER_POW_P2, u))));
+    case PARSER_ATAN:
+        return node(PARSER_DIV, du, node(PARSER_ADD, number(1.0), f1(PARSER_POW_P2, u)));
+    case PARSER_SINH:
+        return mul(f1(PARSER_COSH, u), du);
+    case PARSER_COSH:
+        return mul(f1(PARSER_SINH, u), du);
+    case PARSER_TANH:
+        return mul(node(PARSER_SUB, number(1.0), f1(PARSER_POW_P2, (struct parser_node*)n)), du);
+    case PARSER_ABS: // sign(u) * du
+        return mul(node(PARSER_SUB, f2(PARSER_GT, u, number(0.0)),
+                                    f2(PARSER_LT, u, number(0.0))), du);
+    case PARSER_FLOOR:
+    case PARSER_CEIL:
+        return nullptr;
+    case PARSER_POW_M3:
+        return mul(node(PARSER_MUL, number(-3.0), node(PARSER_DIV, (struct parser_node*)n, u)), du);
+    case PARSER_POW_M2:
+        return mul(node(PARSER_MUL, number(-2.0), f1(PARSER_POW_M3, u)), du);
+    case PARSER_POW_M1:
+        return mul(node(PARSER_NEG, f1(PARSER_POW_M2, u), nullptr), du);
+    case PARSER_POW_P1:
+        return du;
+    case PARSER_POW_P2:
+        return mul(node(PARSER_MUL, number(2.0), u), du);
+    case PARSER_POW_P3:
+        return mul(node(PARSER_MUL, number(3.0), f1(PARSER_POW_P2, u)), du);
+    default:
+        amrex::Abort("parser_derivative: unknown function");
+        return nullptr;
+    }
+}
+
+struct parser_node*
+ParserDerivative::d_f2 (struct parser_f2* n)
+{
+    struct parser_node* a = n->l;
+    struct parser_node* b = n->r;
+    switch (n->ftype)
+    {
+    case PARSER_POW:
+    {
+        struct parser_node* da = d(a);
+        struct parser_node* db = d(b);
+        // b*a**(b-1)*da + a**b*log(a)*db
+        struct parser_node* r = nullptr;
+        if (da) {
+            r = mul(node(PARSER_MUL, b, f2(PARSER_POW, a, node(PARSER_SUB, b, number(1.0)))), da);
+        }
+        if (db) {
+            r = add(r, mul(node(PARSER_MUL, (struct parser_node*)n, f1(PARSER_LOG, a)), db));
+        }
+        return r;
+    }
+    case PARSER_GT:
+    case PARSER_LT:
+    case PARSER_GEQ:
+    case PARSER_LEQ:
+    case PARSER_EQ:
+    case PARSER_NEQ:
+    case PARSER_AND:
+    case PARSER_OR:
+    case PARSER_HEAVISIDE:
+        return nullptr;
+    case PARSER_JN: // (jn(n-1,b) - jn(n+1,b))/2 * db
+        return mul(node(PARSER_MUL, number(0.5),
+                        node(PARSER_SUB, f2(PARSER_JN, node(PARSER_SUB, a, number(1.0)), b),
+                                         f2(PARSER_JN, node(PARSER_ADD, a, number(1.0)), b))),
+                   d(b));
+    case PARSER_MIN:
+    case PARSER_MAX:
+    {
+        struct parser_node* da = d(a);
+        struct parser_node* db = d(b);
+        if (da == nullptr && db == nullptr) { return nullptr; }
+        return track(parser_newf3(PARSER_IF,
+                                  f2((n->ftype == PARSER_MIN) ? PARSER_LT : PARSER_GT, a, b),
+                                  (da) ? da : number(0.0), (db) ? db : number(0.0)));
+    }
+    case PARSER_FMOD: // da - (a-fmod(a,b))/b * db
+    {
+        struct parser_node* db = d(b);
+        return sub(d(a), (db) ? mul(node(PARSER_DIV, node(PARSER_SUB, a, (struct parser_node*)n),
+                                         b), db)
+                              : nullptr);
+    }
+    default:
+        amrex::Abort("parser_derivative: unknown function");
+        return nullptr;
+    }
+}
+
+}
+
+struct amrex_parser*
+parser_derivative (struct amrex_parser* parser, char const* var)
+{
+    ParserDerivative pd;
+    pd.var = var;
+
+    // The assignments are kept, each followed by the assignment of its
+    // derivative if that is not zero.
+    struct parser_node* root = nullptr;
+    auto append = [&] (struct parser_node* n) {
+        root = (root) ? pd.track(parser_newlist(root, n)) : n;
+    };
+    std::vector<struct parser_node*> nodes{parser->ast};
+    while (!nodes.empty()) {
+        struct parser_node* node = nodes.back();
+        nodes.pop_back();
+        if (node->type == PARSER_LIST) {
+            nodes.push_back(node->r);
+            nodes.push_back(node->l);
+        } else if (node->type == PARSER_ASSIGN) {
+            auto asgn = (struct parser_assign*)node;
+            struct parser_node* dv = pd.d(asgn->v);
+            append(node);
+            std::string name(asgn->s->name);
+            if (dv) {
+                std::string dname = "@d_" + name;
+                struct parser_node* sym = pd.symbol(dname);
+                append(pd.track(parser_newassign((struct parser_symbol*)sym, dv)));
+                pd.local_d[name] = sym;
+            } else {
+                pd.local_d[name] = nullptr;
+            }
+        } else {
+            struct parser_node* dn = pd.d(node);
+            append((dn) ? dn : pd.number(0.0));
+        }
+    }
+
+    auto result = (struct amrex_parser*) std::malloc(sizeof(struct amrex_parser));
+    result->sz_mempool = parser_ast_size(root);
+    result->p_root = std::malloc(result->sz_mempool);
+    result->p_free = result->p_root;
+    result->ast = parser_ast_dup(result, root, 0);
+    parser_ast_optimize(result->ast);
+
+    for (auto* p : pd.new_nodes) {
+        std::free(p);
+    }
+    return result;
+}
+
 void
 parser_regvar (struct amrex_parser* parser, char const* name, int i)
 {
@@ -8,11 +8,15 @@
 #include <AMReX_EB2_IF_Torus.H>
 #include <AMReX_EB2_IF_Spline.H>
 #include <AMReX_EB2_IF_Parser.H>
+#include <AMReX_EB2_IF_STL.H>
 #include <AMReX_EB2_GeometryShop.H>
 #include <AMReX_EB2.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
 #include <AMReX.H>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -184,8 +188,62 @@ Build (const Geometry& geom, int required_coarsening_level,
         pp.get("parser_function", fn_string);
         Parser parser(fn_string);
         parser.registerVariables({"x","y","z"});
-        EB2::ParserIF pif(parser.compile<3>());
-        EB2::GeometryShop<EB2::ParserIF,Parser> gshop(pif,parser);
+        bool use_derivative = true;
+        pp.queryAdd("parser_use_derivative", use_derivative);
+        // The derivatives are only used if they all fit in the executor's stack.
+        Vector<Parser> parsers{parser};
+        if (use_derivative) {
+            for (char const* var : {AMREX_D_DECL("x","y","z")}) {
+                parsers.push_back(parser.derivative(var));
+                if (parsers.back().maxStackSize() > AMREX_PARSER_STACK_SIZE) {
+                    use_derivative = false;
+                }
+            }
+        }
+        if (use_derivative) {
+            GpuArray<ParserExecutor<3>,AMREX_SPACEDIM> dpif;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                dpif[idim] = parsers[idim+1].compile<3>();
+            }
+            EB2::ParserIF pif(parser.compile<3>(), dpif);
+            EB2::GeometryShop<EB2::ParserIF,Vector<Parser>> gshop(pif,parsers);
+            EB2::Build(gshop, geom, required_coarsening_level,
+                       max_coarsening_level, ngrow, build_coarse_level_by_coarsening);
+        } else {
+            EB2::ParserIF pif(parser.compile<3>());
+            EB2::GeometryShop<EB2::ParserIF,Parser> gshop(pif,parser);
+            EB2::Build(gshop, geom, required_coarsening_level,
+                       max_coarsening_level, ngrow, build_coarse_level_by_coarsening);
+        }
+    }
+    else if (geom_type == "chkpt_file")
+    {
+        std::string chkpt_file;
+        pp.get("chkpt_file", chkpt_file);
+        EB2::BuildFromChkptFile(chkpt_file, geom);
+    }
+    else if (geom_type == "stl")
+    {
+        std::string stl_file;
+        pp.get("stl_file", stl_file);
+
+        Real stl_scale = 1.0;
+        pp.queryAdd("stl_scale", stl_scale);
+
+        Array<Real,3> stl_center{{0.0,0.0,0.0}};
+        pp.queryAdd("stl_center", stl_center);
+
+        bool stl_has_fluid_inside = false;
+        pp.queryAdd("stl_has_fluid_inside", stl_has_fluid_inside);
+
+        Real stl_max_distance = -1.0;
+        pp.queryAdd("stl_max_distance", stl_max_distance);
+
+        auto stl = std::make_shared<STLtools>();
+        stl->read_stl_file(stl_file, stl_scale, stl_center);
+
+        EB2::STLIF sif(*stl, stl_has_fluid_inside, stl_max_distance);
+        EB2::GeometryShop<EB2::STLIF,std::shared_ptr<STLtools>> gshop(sif,stl);
         EB2::Build(gshop, geom, required_coarsening_level,
                    max_coarsening_level, ngrow, build_coarse_level_by_coarsening);
     }
@@ -193,6 +251,88 @@ Build (const Geometry& geom, int required_coarsening_level,
     {
         amrex::Abort("geom_type "+geom_type+ " not supported");
     }
+
+    std::string write_chkpt_file;
+    if (pp.query("write_chkpt_file", write_chkpt_file)) {
+        IndexSpace::top().writeToChkptFile(write_chkpt_file);
+    }
+}
+
+void
+writeChkptFileHeader (const std::string& dirname, Vector<Box> const& domain)
+{
+    const int nlevs = domain.size();
+    amrex::PreBuildDirectorHierarchy(dirname, "Level_", nlevs, true);
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream ofs(dirname+"/Header");
+        ofs << "EB2::IndexSpace\n" << nlevs << "\n";
+        for (auto const& b : domain) {
+            ofs << b << "\n";
+        }
+        if (!ofs.good()) {
+            amrex::FileOpenFailed(dirname+"/Header");
+        }
+    }
+}
+
+IndexSpaceChkptFile::IndexSpaceChkptFile (const std::string& dirname, const Geometry& geom)
+{
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(dirname+"/Header", fileCharPtr);
+    std::istringstream ifs(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    std::string tag;
+    int nlevs = 0;
+    ifs >> tag >> nlevs;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tag == "EB2::IndexSpace" && nlevs > 0,
+                                     "EB2: "+dirname+" is not an IndexSpace checkpoint");
+
+    m_chkpt_level.reserve(nlevs);
+    for (int ilev = 0; ilev < nlevs; ++ilev)
+    {
+        Box domain;
+        ifs >> domain;
+        Geometry const& g = (ilev == 0) ? geom : amrex::coarsen(m_geom.back(),2);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(g.Domain() == domain,
+                                         "EB2: the domain of "+dirname+"/Level_"+std::to_string(ilev)
+                                         +" does not match the Geometry");
+        m_geom.push_back(g);
+        m_domain.push_back(domain);
+        m_chkpt_level.emplace_back(this, g, dirname+"/Level_"+std::to_string(ilev));
+    }
+}
+
+const Level&
+IndexSpaceChkptFile::getLevel (const Geometry& geom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), geom.Domain());
+    int i = std::distance(m_domain.begin(), it);
+    return m_chkpt_level[i];
+}
+
+const Geometry&
+IndexSpaceChkptFile::getGeometry (const Box& dom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), dom);
+    int i = std::distance(m_domain.begin(), it);
+    return m_geom[i];
+}
+
+void
+IndexSpaceChkptFile::writeToChkptFile (const std::string& dirname) const
+{
+    writeChkptFileHeader(dirname, m_domain);
+    for (int ilev = 0, nlevs = m_chkpt_level.size(); ilev < nlevs; ++ilev) {
+        m_chkpt_level[ilev].writeToChkptFile(dirname+"/Level_"+std::to_string(ilev));
+    }
+}
+
+void
+BuildFromChkptFile (const std::string& dirname, const Geometry& geom)
+{
+    BL_PROFILE("EB2::BuildFromChkptFile()");
+    IndexSpace::push(new IndexSpaceChkptFile(dirname, geom));
 }
 
 namespace {
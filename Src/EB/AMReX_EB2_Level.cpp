@@ -1,7 +1,10 @@
 
 #include <AMReX_EB2_Level.H>
 #include <AMReX_IArrayBox.H>
+#include <AMReX_iMultiFab.H>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -916,4 +919,132 @@ Level::fillLevelSet (MultiFab& levelset, const Geometry& geom) const
     }
 }
 
+void
+Level::writeToChkptFile (const std::string& dirname) const
+{
+    BL_PROFILE("EB2::Level::writeToChkptFile()");
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream ofs(dirname+"/Header");
+        ofs.precision(17);
+        ofs << m_allregular << " " << m_ok << "\n"
+            << m_ngrow << "\n"
+            << m_grids.size() << " " << m_covered_grids.size() << "\n";
+        // BoxArray::readFrom cannot read back an empty BoxArray
+        if (!m_grids.empty()) {
+            m_grids.writeOn(ofs);
+            ofs << "\n";
+        }
+        if (!m_covered_grids.empty()) {
+            m_covered_grids.writeOn(ofs);
+            ofs << "\n";
+        }
+        if (!ofs.good()) {
+            amrex::FileOpenFailed(dirname+"/Header");
+        }
+    }
+
+    if (m_allregular) { return; }
+
+    // EBCellFlag is stored as its bits, which a Real cannot hold in single precision
+    iMultiFab cellflag(m_grids, m_dmap, 1, m_cellflag.nGrow());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cellflag); mfi.isValid(); ++mfi)
+    {
+        auto const& src = m_cellflag.const_array(mfi);
+        auto const& dst = cellflag.array(mfi);
+        AMREX_HOST_DEVICE_FOR_3D(mfi.fabbox(), i, j, k,
+        {
+            dst(i,j,k) = static_cast<int>(src(i,j,k).getValue());
+        });
+    }
+
+    amrex::Write(cellflag, dirname+"/cellflag");
+    VisMF::Write(m_levelset, dirname+"/levelset");
+    VisMF::Write(m_volfrac, dirname+"/volfrac");
+    VisMF::Write(m_centroid, dirname+"/centroid");
+    VisMF::Write(m_bndryarea, dirname+"/bndryarea");
+    VisMF::Write(m_bndrycent, dirname+"/bndrycent");
+    VisMF::Write(m_bndrynorm, dirname+"/bndrynorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Write(m_areafrac[idim], dirname+"/areafrac_"+std::to_string(idim));
+        VisMF::Write(m_facecent[idim], dirname+"/facecent_"+std::to_string(idim));
+        VisMF::Write(m_edgecent[idim], dirname+"/edgecent_"+std::to_string(idim));
+    }
+}
+
+ChkptFileLevel::ChkptFileLevel (IndexSpace const* is, const Geometry& geom,
+                                const std::string& dirname)
+    : Level(is, geom)
+{
+    BL_PROFILE("EB2::ChkptFileLevel()");
+
+    {
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(dirname+"/Header", fileCharPtr);
+        std::istringstream ifs(fileCharPtr.dataPtr(), std::istringstream::in);
+        Long nboxes, ncovered;
+        ifs >> m_allregular >> m_ok >> m_ngrow >> nboxes >> ncovered;
+        if (nboxes > 0) { m_grids.readFrom(ifs); }
+        if (ncovered > 0) { m_covered_grids.readFrom(ifs); }
+    }
+
+    if (m_allregular) {
+        m_grids = BoxArray();
+        return;
+    }
+
+    MFInfo mf_info;
+    mf_info.SetTag("EB2::Level");
+
+    // The data are distributed over the current processes, which need not
+    // be the processes that wrote them.  Reading the cell flags makes the
+    // DistributionMapping used for the rest.
+    {
+        iMultiFab cellflag;
+        amrex::Read(cellflag, dirname+"/cellflag");
+        m_dmap = cellflag.DistributionMap();
+        m_cellflag.define(m_grids, m_dmap, 1, cellflag.nGrowVect(), mf_info);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(cellflag); mfi.isValid(); ++mfi)
+        {
+            auto const& src = cellflag.const_array(mfi);
+            auto const& dst = m_cellflag.array(mfi);
+            AMREX_HOST_DEVICE_FOR_3D(mfi.fabbox(), i, j, k,
+            {
+                dst(i,j,k) = EBCellFlag(static_cast<uint32_t>(src(i,j,k)));
+            });
+        }
+    }
+
+    // The header is read once, both to define mf and to read it.
+    auto read_mf = [&] (MultiFab& mf, std::string const& name)
+    {
+        Vector<char> header;
+        VisMF::ReadFAHeader(dirname+"/"+name, header);
+        VisMF::Header hdr;
+        std::istringstream iss(header.dataPtr(), std::istringstream::in);
+        iss >> hdr;
+        mf.define(hdr.m_ba, m_dmap, hdr.m_ncomp, hdr.m_ngrow, mf_info);
+        VisMF::Read(mf, dirname+"/"+name, header.dataPtr());
+    };
+
+    read_mf(m_levelset, "levelset");
+    read_mf(m_volfrac, "volfrac");
+    read_mf(m_centroid, "centroid");
+    read_mf(m_bndryarea, "bndryarea");
+    read_mf(m_bndrycent, "bndrycent");
+    read_mf(m_bndrynorm, "bndrynorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        read_mf(m_areafrac[idim], "areafrac_"+std::to_string(idim));
+        read_mf(m_facecent[idim], "facecent_"+std::to_string(idim));
+        read_mf(m_edgecent[idim], "edgecent_"+std::to_string(idim));
+    }
+}
+
 }}
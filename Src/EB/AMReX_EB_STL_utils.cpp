@@ -1,5 +1,14 @@
 #include<AMReX_EB_STL_utils.H>
 #include<AMReX_EB_triGeomOps_K.H>
+#include<AMReX_BLProfiler.H>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <numeric>
 
 namespace amrex
 {
@@ -81,23 +90,258 @@ namespace amrex
             std::getline(infile,tmpline); //end facet
         }
 
-        //device vectors
-        m_tri_pts_d.resize(m_num_tri*m_ndata_per_tri);
-        m_tri_normals_d.resize(m_num_tri*m_ndata_per_normal);
+        build_bvh();
+        copy_to_device();
+    }
+    //================================================================================
+    void STLtools::read_binary_stl_file(std::string fname)
+    {
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(fname, fileCharPtr);
+        const std::size_t nbytes = fileCharPtr.size()-1; //ReadAndBcastFile appends '\0'
+
+        if(amrex::Verbose())
+            Print()<<"STL file name:"<<fname<<"\n";
+
+        //80 byte header, number of triangles, then 50 bytes per triangle:
+        //normal and three vertices as 32-bit floats and a 16-bit attribute
+        std::uint32_t ntri=0;
+        if(nbytes >= 84)
+        {
+            std::memcpy(&ntri, fileCharPtr.data()+80, sizeof(ntri));
+        }
+        if(nbytes < 84 || nbytes < 84+std::size_t(ntri)*50)
+        {
+            Abort("STLtools::read_binary_stl_file: "+fname+" is not a binary STL file\n");
+        }
+
+        m_num_tri=static_cast<int>(ntri);
+
+        if(amrex::Verbose())
+            Print()<<"number of triangles:"<<m_num_tri<<"\n";
+
+        m_tri_pts_h.resize(m_num_tri*m_ndata_per_tri);
+        m_tri_normals_h.resize(m_num_tri*m_ndata_per_normal);
+
+        const char* p=fileCharPtr.data()+84;
+        for(int i=0;i<m_num_tri;i++,p+=50)
+        {
+            float v[12];
+            std::memcpy(v, p, sizeof(v));
+            for(int n=0;n<m_ndata_per_normal;n++)
+            {
+                m_tri_normals_h[i*m_ndata_per_normal+n]=v[n];
+            }
+            for(int n=0;n<m_ndata_per_tri;n++)
+            {
+                m_tri_pts_h[i*m_ndata_per_tri+n]=v[3+n];
+            }
+        }
+
+        build_bvh();
+        copy_to_device();
+    }
+    //================================================================================
+    void STLtools::read_stl_file(std::string fname, Real scale,
+            Array<Real,3> const& center)
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(scale > 0.0, "STLtools::read_stl_file: scale must be positive");
+        m_scale=scale;
+        m_center=center;
+
+        //a binary file has exactly 84+50*ntri bytes; some binary files also
+        //start with "solid", so this is checked first
+        bool is_binary=false;
+        if(ParallelDescriptor::IOProcessor())
+        {
+            std::ifstream ifs(fname, std::ios::in|std::ios::binary);
+            if(!ifs.good())
+            {
+                amrex::FileOpenFailed(fname);
+            }
+            char header[84];
+            ifs.read(header, 84);
+            if(ifs.gcount() == 84)
+            {
+                std::uint32_t ntri;
+                std::memcpy(&ntri, header+80, sizeof(ntri));
+                ifs.seekg(0, std::ios::end);
+                const auto nbytes = static_cast<std::size_t>(ifs.tellg());
+                is_binary = (nbytes == 84+std::size_t(ntri)*50)
+                    || std::strncmp(header, "solid", 5) != 0;
+            }
+        }
+        int flag=is_binary;
+        ParallelDescriptor::Bcast(&flag, 1, ParallelDescriptor::IOProcessorNumber());
+
+        if(flag)
+        {
+            read_binary_stl_file(fname);
+        }
+        else
+        {
+            read_ascii_stl_file(fname);
+        }
+    }
+    //================================================================================
+    void STLtools::build_bvh()
+    {
+        BL_PROFILE("STLtools::build_bvh()");
+
+        constexpr int leaf_size=4;
+
+        if(m_scale != 1.0 || m_center[0] != 0.0 || m_center[1] != 0.0 || m_center[2] != 0.0)
+        {
+            for(int i=0;i<m_num_tri*m_ndata_per_tri;i++)
+            {
+                m_tri_pts_h[i]=m_tri_pts_h[i]*m_scale+m_center[i%3];
+            }
+        }
+
+        //bounding box and centroid of each triangle
+        Vector<Real> tlo(m_num_tri*3), thi(m_num_tri*3), tc(m_num_tri*3);
+        for(int i=0;i<m_num_tri;i++)
+        {
+            for(int d=0;d<3;d++)
+            {
+                Real a=m_tri_pts_h[i*m_ndata_per_tri+d];
+                Real b=m_tri_pts_h[i*m_ndata_per_tri+3+d];
+                Real c=m_tri_pts_h[i*m_ndata_per_tri+6+d];
+                tlo[i*3+d]=std::min({a,b,c});
+                thi[i*3+d]=std::max({a,b,c});
+                tc[i*3+d]=(a+b+c)/3.0;
+            }
+        }
+
+        Vector<int> order(m_num_tri);
+        std::iota(order.begin(), order.end(), 0);
+
+        m_bvh_nodes_h.clear();
+        m_bvh_nodes_h.reserve(std::max(1, 2*(m_num_tri/leaf_size)+1));
+
+        //median split along the longest extent of the centroids; the depth
+        //is about log2(m_num_tri/leaf_size), far below stl_bvh::max_depth
+        std::function<void(int,int)> build = [&] (int b, int e)
+        {
+            const int inode=static_cast<int>(m_bvh_nodes_h.size());
+            m_bvh_nodes_h.push_back(STLBVHNode{});
+            STLBVHNode node;
+            Real clo[3], chi[3];
+            for(int d=0;d<3;d++)
+            {
+                node.lo[d]=clo[d]= std::numeric_limits<Real>::max();
+                node.hi[d]=chi[d]=-std::numeric_limits<Real>::max();
+            }
+            for(int n=b;n<e;n++)
+            {
+                const int i=order[n];
+                for(int d=0;d<3;d++)
+                {
+                    node.lo[d]=std::min(node.lo[d],tlo[i*3+d]);
+                    node.hi[d]=std::max(node.hi[d],thi[i*3+d]);
+                    clo[d]=std::min(clo[d],tc[i*3+d]);
+                    chi[d]=std::max(chi[d],tc[i*3+d]);
+                }
+            }
+
+            if(e-b <= leaf_size)
+            {
+                node.first=b;
+                node.count=e-b;
+                m_bvh_nodes_h[inode]=node;
+                return;
+            }
+
+            int dir=0;
+            for(int d=1;d<3;d++)
+            {
+                if(chi[d]-clo[d] > chi[dir]-clo[dir]) dir=d;
+            }
+            const int m=b+(e-b)/2;
+            std::nth_element(order.begin()+b, order.begin()+m, order.begin()+e,
+                    [&] (int i, int j) { return tc[i*3+dir] < tc[j*3+dir]; });
+
+            build(b,m);
+            node.first=static_cast<int>(m_bvh_nodes_h.size());
+            node.count=0;
+            build(m,e);
+            m_bvh_nodes_h[inode]=node;
+        };
+
+        if(m_num_tri > 0)
+        {
+            build(0,m_num_tri);
+        }
+
+        //store the triangles in the order of the leaves
+        Gpu::PinnedVector<Real> pts(m_tri_pts_h.size());
+        Gpu::PinnedVector<Real> nrm(m_tri_normals_h.size());
+        for(int n=0;n<m_num_tri;n++)
+        {
+            const int i=order[n];
+            for(int c=0;c<m_ndata_per_tri;c++)
+            {
+                pts[n*m_ndata_per_tri+c]=m_tri_pts_h[i*m_ndata_per_tri+c];
+            }
+            for(int c=0;c<m_ndata_per_normal;c++)
+            {
+                nrm[n*m_ndata_per_normal+c]=m_tri_normals_h[i*m_ndata_per_normal+c];
+            }
+        }
+        std::swap(pts, m_tri_pts_h);
+        std::swap(nrm, m_tri_normals_h);
+
+        if(amrex::Verbose())
+            Print()<<"number of BVH nodes:"<<m_bvh_nodes_h.size()<<"\n";
+    }
+    //================================================================================
+    void STLtools::get_point_outside(Real po[3]) const
+    {
+        AMREX_ALWAYS_ASSERT(!m_bvh_nodes_h.empty());
+        const STLBVHNode& root=m_bvh_nodes_h[0];
+        //offsets that differ in each direction keep the segments to this
+        //point away from being parallel to the axis-aligned facets
+        const Real frac[3]={0.113, 0.127, 0.139};
+        for(int d=0;d<3;d++)
+        {
+            const Real len=std::max(root.hi[d]-root.lo[d], Real(1.e-6)*(Math::abs(root.lo[d])+1.0));
+            po[d]=root.lo[d]-frac[d]*len;
+        }
+    }
+    //================================================================================
+    void STLtools::get_bounding_box(Real lo[3], Real hi[3]) const
+    {
+        AMREX_ALWAYS_ASSERT(!m_bvh_nodes_h.empty());
+        for(int d=0;d<3;d++)
+        {
+            lo[d]=m_bvh_nodes_h[0].lo[d];
+            hi[d]=m_bvh_nodes_h[0].hi[d];
+        }
+    }
+    //================================================================================
+    void STLtools::copy_to_device()
+    {
+        m_tri_pts_d.resize(m_tri_pts_h.size());
+        m_tri_normals_d.resize(m_tri_normals_h.size());
+        m_bvh_nodes_d.resize(m_bvh_nodes_h.size());
 
         Gpu::copy(Gpu::hostToDevice, m_tri_pts_h.begin(),
                 m_tri_pts_h.end(), m_tri_pts_d.begin());
         Gpu::copy(Gpu::hostToDevice,
                 m_tri_normals_h.begin(), m_tri_normals_h.end(),
                 m_tri_normals_d.begin());
+        Gpu::copy(Gpu::hostToDevice,
+                m_bvh_nodes_h.begin(), m_bvh_nodes_h.end(),
+                m_bvh_nodes_d.begin());
+        Gpu::streamSynchronize();
     }
     //================================================================================
     void STLtools::stl_to_markerfab(MultiFab& markerfab,Geometry geom,
             Real *point_outside)
     {
+        BL_PROFILE("STLtools::stl_to_markerfab()");
+
         //local variables for lambda capture
-        int data_stride   = m_ndata_per_tri;
-        int num_triangles = m_num_tri;
         Real outvalue     = m_outside;
         Real invalue      = m_inside;
 
@@ -106,16 +350,25 @@ namespace amrex
         GpuArray<Real,3> outp={point_outside[0],point_outside[1],point_outside[2]};
 
         const Real *tri_pts=m_tri_pts_d.data();
+        const STLBVHNode *nodes=m_bvh_nodes_d.data();
 
-        for (MFIter mfi(markerfab); mfi.isValid(); ++mfi) // Loop over grids
+        if(m_num_tri == 0)
         {
-            const Box& bx = mfi.validbox();
-            auto mfab_arr=markerfab[mfi].array();
+            markerfab.setVal(outvalue);
+            return;
+        }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(markerfab,TilingIfNotGPU()); mfi.isValid(); ++mfi) // Loop over grids
+        {
+            const Box& bx = mfi.tilebox();
+            auto mfab_arr=markerfab.array(mfi);
 
             ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k)
             {
                 Real coords[3],po[3];
-                Real t1[3],t2[3],t3[3];
 
                 coords[0]=plo[0]+i*dx[0];
                 coords[1]=plo[1]+j*dx[1];
@@ -125,26 +378,7 @@ namespace amrex
                 po[1]=outp[1];
                 po[2]=outp[2];
 
-                int num_intersects=0;
-                int intersect;
-
-                for(int tr=0;tr<num_triangles;tr++)
-                {
-                    t1[0]=tri_pts[tr*data_stride+0];
-                    t1[1]=tri_pts[tr*data_stride+1];
-                    t1[2]=tri_pts[tr*data_stride+2];
-
-                    t2[0]=tri_pts[tr*data_stride+3];
-                    t2[1]=tri_pts[tr*data_stride+4];
-                    t2[2]=tri_pts[tr*data_stride+5];
-
-                    t3[0]=tri_pts[tr*data_stride+6];
-                    t3[1]=tri_pts[tr*data_stride+7];
-                    t3[2]=tri_pts[tr*data_stride+8];
-
-                    intersect = tri_geom_ops::lineseg_tri_intersect(po,coords,t1,t2,t3);
-                    num_intersects += (1-intersect);
-                }
+                int num_intersects=stl_bvh::num_intersects(nodes,tri_pts,po,coords);
                 if(num_intersects%2 == 0)
                 {
                     mfab_arr(i,j,k)=outvalue;
@@ -158,4 +392,47 @@ namespace amrex
         }
     }
     //================================================================================
+    void STLtools::stl_to_signed_distance(MultiFab& distfab,Geometry geom,
+            Real *point_outside)
+    {
+        BL_PROFILE("STLtools::stl_to_signed_distance()");
+
+        const auto plo   = geom.ProbLoArray();
+        const auto dx    = geom.CellSizeArray();
+        GpuArray<Real,3> outp={point_outside[0],point_outside[1],point_outside[2]};
+
+        const Real *tri_pts=m_tri_pts_d.data();
+        const STLBVHNode *nodes=m_bvh_nodes_d.data();
+
+        if(m_num_tri == 0)
+        {
+            distfab.setVal(std::numeric_limits<Real>::max());
+            return;
+        }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(distfab,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            auto dist_arr=distfab.array(mfi);
+
+            ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k)
+            {
+                Real coords[3],po[3];
+
+                coords[0]=plo[0]+i*dx[0];
+                coords[1]=plo[1]+j*dx[1];
+                coords[2]=plo[2]+k*dx[2];
+
+                po[0]=outp[0];
+                po[1]=outp[1];
+                po[2]=outp[2];
+
+                dist_arr(i,j,k)=stl_bvh::signed_distance(nodes,tri_pts,coords,po);
+            });
+        }
+    }
+    //================================================================================
 }
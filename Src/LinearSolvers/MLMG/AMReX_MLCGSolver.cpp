@@ -49,6 +49,77 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+#ifdef BL_USE_MPI
+// Sums all the values but the last one, which is a norm and is maxed.
+void
+sum_max (void* invec, void* inoutvec, int* len, MPI_Datatype* /*datatype*/)
+{
+    const Real* in = static_cast<const Real*>(invec);
+    Real* inout = static_cast<Real*>(inoutvec);
+    for (int i = 0; i < *len-1; ++i) {
+        inout[i] += in[i];
+    }
+    inout[*len-1] = std::max(inout[*len-1], in[*len-1]);
+}
+
+MPI_Op sum_max_op = MPI_OP_NULL;
+
+void
+free_sum_max_op ()
+{
+    if (sum_max_op != MPI_OP_NULL) {
+        MPI_Op_free(&sum_max_op);
+        sum_max_op = MPI_OP_NULL;
+    }
+}
+#endif
+
+/**
+* All-reduce of local dot products followed by a local inf-norm, summing
+* the former and maxing the latter in one message.  start() posts a
+* non-blocking all-reduce so that the pipelined solvers can overlap it
+* with an operator apply.  The values must stay alive until finish()
+* returns.
+*/
+class DotsAndNormReduce
+{
+public:
+    explicit DotsAndNormReduce (MPI_Comm comm) noexcept : m_comm(comm) {}
+
+    void start (Real* vals, int n)
+    {
+#ifdef BL_USE_MPI
+        if (ParallelDescriptor::NProcs(m_comm) > 1) {
+            if (sum_max_op == MPI_OP_NULL) {
+                MPI_Op_create(sum_max, 1, &sum_max_op);
+                amrex::ExecOnFinalize(free_sum_max_op);
+            }
+            MPI_Iallreduce(MPI_IN_PLACE, vals, n, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                           sum_max_op, m_comm, &m_request);
+            m_pending = true;
+        }
+#else
+        amrex::ignore_unused(vals,n);
+#endif
+    }
+
+    void finish ()
+    {
+#ifdef BL_USE_MPI
+        if (m_pending) {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+            m_pending = false;
+        }
+#endif
+    }
+
+private:
+    MPI_Comm m_comm;
+    MPI_Request m_request;
+    bool m_pending = false;
+};
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -73,8 +144,12 @@ MLCGSolver::solve (MultiFab&       sol,
 {
     if (solver_type == Type::BiCGStab) {
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
-    } else {
+    } else if (solver_type == Type::CG) {
         return solve_cg(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipeCG) {
+        return solve_pipecg(sol,rhs,eps_rel,eps_abs);
+    } else {
+        return solve_pipebicgstab(sol,rhs,eps_rel,eps_abs);
     }
 }
 
@@ -118,7 +193,15 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real rnorm = norm_inf(r);
+    // rho = (rh,r) is computed with the norm of r.
+    const MultiFab* rhr[2] = {&rh, &r};
+    Real rho, rnorm;
+    {
+        Real vals[2];
+        dotxy_norm_inf(1, &rhr[0], &rhr[1], &r, vals);
+        rho = vals[0];
+        rnorm = vals[1];
+    }
     const Real rnorm0   = rnorm;
 
     if ( verbose > 0 )
@@ -142,7 +225,6 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     for (; iter <= maxiter; ++iter)
     {
-        const Real rho = dotxy(rh,r);
         if ( rho == 0 )
         {
             ret = 1; break;
@@ -191,16 +273,11 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         MultiFab::Copy(sh,s,0,0,ncomp,nghost);
         Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, t);
-        //
-        // This is a little funky.  I want to elide one of the reductions
-        // in the following two dotxy()s.  We do that by calculating the "local"
-        // values and then reducing the two local values at the same time.
-        //
-        Real tvals[2] = { dotxy(t,t,true), dotxy(t,s,true) };
-
-        BL_PROFILE_VAR("MLCGSolver::ParallelAllReduce", blp_par);
-        ParallelAllReduce::Sum(tvals,2,Lp.BottomCommunicator());
-        BL_PROFILE_VAR_STOP(blp_par);
+        // (t,t) and (t,s) in one pass with one reduction
+        const MultiFab* tx[2] = {&t, &t};
+        const MultiFab* ty[2] = {&t, &s};
+        Real tvals[2];
+        dotxy_norm_inf(2, tx, ty, nullptr, tvals);
 
         if ( tvals[0] != Real(0.0) )
         {
@@ -215,7 +292,13 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, r);
 
-        rnorm = norm_inf(r);
+        rho_1 = rho;
+        {
+            Real vals[2];
+            dotxy_norm_inf(1, &rhr[0], &rhr[1], &r, vals);
+            rho = vals[0];
+            rnorm = vals[1];
+        }
 
         if ( verbose > 2 )
         {
@@ -231,7 +314,6 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         {
             ret = 4; break;
         }
-        rho_1 = rho;
     }
 
     if ( verbose > 0 )
@@ -281,7 +363,6 @@ MLCGSolver::solve_cg (MultiFab&       sol,
 
     MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
     MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
     MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
 
     MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
@@ -290,7 +371,15 @@ MLCGSolver::solve_cg (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real       rnorm    = norm_inf(r);
+    // Without preconditioner, rho = (r,r) is computed with the norm of r.
+    const MultiFab* pr = &r;
+    Real rho, rnorm;
+    {
+        Real vals[2];
+        dotxy_norm_inf(1, &pr, &pr, &r, vals);
+        rho = vals[0];
+        rnorm = vals[1];
+    }
     const Real rnorm0   = rnorm;
 
     if ( verbose > 0 )
@@ -314,22 +403,18 @@ MLCGSolver::solve_cg (MultiFab&       sol,
 
     for (; iter <= maxiter; ++iter)
     {
-        MultiFab::Copy(z,r,0,0,ncomp,nghost);
-
-        Real rho = dotxy(z,r);
-
         if ( rho == 0 )
         {
             ret = 1; break;
         }
         if (iter == 1)
         {
-            MultiFab::Copy(p,z,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
         }
         else
         {
             Real beta = rho/rho_1;
-            sxay(p, z, beta, p, nghost);
+            sxay(p, r, beta, p, nghost);
         }
         Lp.apply(amrlev, mglev, q, p, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
 
@@ -353,7 +438,14 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         }
         sxay(sol, sol, alpha, p, nghost);
         sxay(  r,   r,-alpha, q, nghost);
-        rnorm = norm_inf(r);
+
+        rho_1 = rho;
+        {
+            Real vals[2];
+            dotxy_norm_inf(1, &pr, &pr, &r, vals);
+            rho = vals[0];
+            rnorm = vals[1];
+        }
 
         if ( verbose > 2 )
         {
@@ -364,8 +456,6 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         }
 
         if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
-
-        rho_1 = rho;
     }
 
     if ( verbose > 0 )
@@ -396,6 +486,389 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipecg (MultiFab&       sol,
+                          const MultiFab& rhs,
+                          Real            eps_rel,
+                          Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipecg");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // r and w are the inputs of the operator applies.
+    MultiFab r(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    MultiFab w(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Real       rnorm    = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int ret = 0;
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_PipeCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    DotsAndNormReduce reduce(Lp.BottomCommunicator());
+    Real gamma_1 = 0, alpha_1 = 0;
+
+    // Each pass reduces (r,r), (w,r) and |r| of the current residual while
+    // q = A w is computed.  The last pass only checks the convergence.
+    for (;;)
+    {
+        const MultiFab* xs[2] = {&r, &w};
+        const MultiFab* ys[2] = {&r, &r};
+        Real vals[3];
+        dotxy_norm_inf(2, xs, ys, &r, vals, true);
+        reduce.start(vals, 3);
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        reduce.finish();
+
+        const Real gamma = vals[0];
+        const Real delta = vals[1];
+        rnorm = vals[2];
+
+        if ( verbose > 2 && iter > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipeCG:   Iteration"
+                           << std::setw(4) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs || iter == maxiter ) break;
+
+        ++iter;
+
+        Real alpha, beta;
+        if (iter == 1)
+        {
+            beta = 0;
+            if ( delta != Real(0.0) )
+            {
+                alpha = gamma/delta;
+            }
+            else
+            {
+                ret = 1; break;
+            }
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            const Real pw = delta - beta*gamma/alpha_1;
+            if ( pw != Real(0.0) )
+            {
+                alpha = gamma/pw;
+            }
+            else
+            {
+                ret = 1; break;
+            }
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeCG:"
+                           << " iter " << iter
+                           << " rho " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        sxay(sol, sol,  alpha, p, nghost);
+        sxay(  r,   r, -alpha, s, nghost);
+        sxay(  w,   w, -alpha, z, nghost);
+
+        gamma_1 = gamma;
+        alpha_1 = alpha;
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_pipebicgstab (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipebicgstab");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // r, w and z are the inputs of the operator applies.
+    MultiFab r(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    MultiFab w(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    MultiFab z(ba, dm, ncomp, sol.nGrowVect(), MFInfo(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab y    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    DotsAndNormReduce reduce(Lp.BottomCommunicator());
+
+    // w = A r and t = A w
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, w);
+
+    Real rho, alpha, beta = 0, omega = 0;
+    {
+        const MultiFab* xs[2] = {&rh, &rh};
+        const MultiFab* ys[2] = {&r, &w};
+        Real vals[3];
+        dotxy_norm_inf(2, xs, ys, &r, vals, true);
+        reduce.start(vals, 3);
+        Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, t);
+        reduce.finish();
+
+        rho = vals[0];
+        if ( rho != Real(0.0) && vals[1] != Real(0.0) )
+        {
+            alpha = rho/vals[1];
+        }
+        else
+        {
+            ret = (rho == Real(0.0)) ? 1 : 2;
+            iter = 0;
+            sol.plus(sorig, 0, ncomp, nghost);
+            return ret;
+        }
+    }
+
+    for (; iter <= maxiter; ++iter)
+    {
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        // (q,y), (y,y) and |q| while v = A z
+        const MultiFab* x1[2] = {&q, &y};
+        const MultiFab* y1[2] = {&y, &y};
+        Real vals1[3];
+        dotxy_norm_inf(2, x1, y1, &q, vals1, true);
+        reduce.start(vals1, 3);
+        Lp.apply(amrlev, mglev, v, z, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, v);
+        reduce.finish();
+
+        sxay(sol, sol, alpha, p, nghost);
+
+        rnorm = vals1[2];
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: Half Iter "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( vals1[1] != Real(0.0) )
+        {
+            omega = vals1[0]/vals1[1];
+        }
+        else
+        {
+            ret = 3; break;
+        }
+        sxay(sol, sol,  omega, q, nghost);
+        sxay(r,     q, -omega, y, nghost);
+        sxay(t,     t, -alpha, v, nghost);
+        sxay(w,     y, -omega, t, nghost);
+
+        // (rh,r), (rh,w), (rh,s), (rh,z) and |r| while t = A w
+        const MultiFab* x2[4] = {&rh, &rh, &rh, &rh};
+        const MultiFab* y2[4] = {&r, &w, &s, &z};
+        Real vals2[5];
+        dotxy_norm_inf(4, x2, y2, &r, vals2, true);
+        reduce.start(vals2, 5);
+        Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, t);
+        reduce.finish();
+
+        rnorm = vals2[4];
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: Iteration "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+        {
+            ret = 4; break;
+        }
+        if ( vals2[0] == 0 )
+        {
+            ret = 1; break;
+        }
+        beta = (vals2[0]/rho)*(alpha/omega);
+        const Real rhTw = vals2[1] + beta*vals2[2] - beta*omega*vals2[3];
+        if ( rhTw != Real(0.0) )
+        {
+            alpha = vals2[0]/rhTw;
+        }
+        else
+        {
+            ret = 2; break;
+        }
+        rho = vals2[0];
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeBiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
@@ -406,6 +879,23 @@ MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
     return result;
 }
 
+void
+MLCGSolver::dotxy_norm_inf (int ndots, const MultiFab* const* x, const MultiFab* const* y,
+                            const MultiFab* r, Real* result, bool local)
+{
+    Lp.xdotyNormInf(amrlev, mglev, ndots, x, y, r, result);
+    if (!local) {
+        if (r) {
+            DotsAndNormReduce reduce(Lp.BottomCommunicator());
+            reduce.start(result, ndots+1);
+            reduce.finish();
+        } else {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(result, ndots, Lp.BottomCommunicator());
+        }
+    }
+}
+
 Real
 MLCGSolver::norm_inf (const MultiFab& res, bool local)
 {
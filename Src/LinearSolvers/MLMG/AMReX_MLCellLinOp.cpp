@@ -1257,6 +1257,14 @@ MLCellLinOp::xdoty (int /*amrlev*/, int /*mglev*/, const MultiFab& x, const Mult
     return result;
 }
 
+void
+MLCellLinOp::xdotyNormInf (int /*amrlev*/, int /*mglev*/, int ndots,
+                           const MultiFab* const* x, const MultiFab* const* y,
+                           const MultiFab* r, Real* result) const
+{
+    fusedXdotyNormInf(ndots, x, y, r, nullptr, result);
+}
+
 MLCellLinOp::BndryCondLoc::BndryCondLoc (const BoxArray& ba, const DistributionMapping& dm, int ncomp)
     : bcond(ba, dm),
       bcloc(ba, dm),
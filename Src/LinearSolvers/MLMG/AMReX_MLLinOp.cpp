@@ -854,6 +854,71 @@ MLLinOp::makeSubCommunicator (const DistributionMapping& dm)
 #endif
 }
 
+void
+MLLinOp::xdotyNormInf (int amrlev, int mglev, int ndots,
+                       const MultiFab* const* x, const MultiFab* const* y,
+                       const MultiFab* r, Real* result) const
+{
+    for (int id = 0; id < ndots; ++id) {
+        result[id] = xdoty(amrlev, mglev, *x[id], *y[id], true);
+    }
+    if (r) {
+        result[ndots] = r->norm0(0, r->nComp(), IntVect(0), true);
+    }
+}
+
+void
+MLLinOp::fusedXdotyNormInf (int ndots, const MultiFab* const* x, const MultiFab* const* y,
+                            const MultiFab* r, const MultiFab* dot_mask, Real* result)
+{
+    BL_PROFILE("MLLinOp::fusedXdotyNormInf()");
+
+    AMREX_ALWAYS_ASSERT(ndots >= 0 && ndots <= max_fused_dots && (r != nullptr || ndots > 0));
+
+    // Without a norm, the loop goes over x[0].
+    const bool has_norm = (r != nullptr);
+    const MultiFab& mf = has_norm ? *r : *x[0];
+    const int ncomp = mf.nComp();
+    // The unused slots point to mf and are skipped.
+    MultiArray4<Real const> xma[max_fused_dots];
+    MultiArray4<Real const> yma[max_fused_dots];
+    for (int id = 0; id < max_fused_dots; ++id) {
+        xma[id] = (id < ndots) ? x[id]->const_arrays() : mf.const_arrays();
+        yma[id] = (id < ndots) ? y[id]->const_arrays() : mf.const_arrays();
+    }
+    auto const& rma = mf.const_arrays();
+    const bool has_mask = (dot_mask != nullptr);
+    auto const& mma = has_mask ? dot_mask->const_arrays() : mf.const_arrays();
+
+    auto tup = ParReduce(TypeList<ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpMax>{},
+                         TypeList<Real,Real,Real,Real,Real>{}, mf, IntVect(0),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+        -> GpuTuple<Real,Real,Real,Real,Real>
+    {
+        Real dots[max_fused_dots] = {0.0, 0.0, 0.0, 0.0};
+        Real rmax = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            for (int id = 0; id < ndots; ++id) {
+                dots[id] += xma[id][box_no](i,j,k,n) * yma[id][box_no](i,j,k,n);
+            }
+            if (has_norm) {
+                rmax = amrex::max(rmax, std::abs(rma[box_no](i,j,k,n)));
+            }
+        }
+        const Real w = has_mask ? mma[box_no](i,j,k) : Real(1.0);
+        return {dots[0]*w, dots[1]*w, dots[2]*w, dots[3]*w, rmax};
+    });
+
+    const Real vals[max_fused_dots+1] = {amrex::get<0>(tup), amrex::get<1>(tup), amrex::get<2>(tup),
+                                         amrex::get<3>(tup), amrex::get<4>(tup)};
+    for (int id = 0; id < ndots; ++id) {
+        result[id] = vals[id];
+    }
+    if (has_norm) {
+        result[ndots] = vals[max_fused_dots];
+    }
+}
+
 void
 MLLinOp::makeAgglomeratedDMap (const Vector<BoxArray>& ba, Vector<DistributionMapping>& dm)
 {
@@ -967,6 +967,10 @@ MLMG::actualBottomSolve ()
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipecg) {
+                cg_type = MLCGSolver::Type::PipeCG;
+            } else if (bottom_solver == BottomSolver::pipebicgstab) {
+                cg_type = MLCGSolver::Type::PipeBiCGStab;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -1022,40 +1026,60 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
     return ret;
 }
 
-// Compute single-level masked inf-norm of Residual (res).
+namespace {
+
+// Inf-norm of all the components of mf in one pass, masked by mask and
+// weighted by the volume fraction if they are not null.
 Real
-MLMG::ResNormInf (int alev, bool local)
+fused_norminf (const MultiFab& mf, const iMultiFab* mask, const MultiFab* vfrac)
+{
+    const int ncomp = mf.nComp();
+    auto const& ma = mf.const_arrays();
+    const bool has_mask = (mask != nullptr);
+    const bool has_vfrac = (vfrac != nullptr);
+    auto const& mskma = has_mask ? mask->const_arrays() : MultiArray4<int const>{};
+    auto const& vfma = has_vfrac ? vfrac->const_arrays() : MultiArray4<Real const>{};
+    return ParReduce(TypeList<ReduceOpMax>{}, TypeList<Real>{}, mf, IntVect(0),
+    [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept -> GpuTuple<Real>
+    {
+        if (has_mask && !mskma[box_no](i,j,k)) { return Real(0.0); }
+        Real r = Real(0.0);
+        for (int n = 0; n < ncomp; ++n) {
+            r = amrex::max(r, std::abs(ma[box_no](i,j,k,n)));
+        }
+        if (has_vfrac) { r *= vfma[box_no](i,j,k); }
+        return r;
+    });
+}
+
+}
+
+// The volume fraction of amr level alev if the norms should be weighted by it.
+const MultiFab*
+MLMG::normVolFrac (int alev) const
 {
-    BL_PROFILE("MLMG::ResNormInf()");
-    const int ncomp = linop.getNComp();
-    const int mglev = 0;
-    Real norm = 0.0;
-    MultiFab* pmf = &(res[alev][mglev]);
 #ifdef AMREX_USE_EB
-    if (linop.isCellCentered() && scratch[alev]) {
-        pmf = scratch[alev].get();
-        MultiFab::Copy(*pmf, res[alev][mglev], 0, 0, ncomp, 0);
+    if (linop.isCellCentered() && rhs[alev].hasEBFabFactory()) {
         auto factory = dynamic_cast<EBFArrayBoxFactory const*>(linop.Factory(alev));
         if (factory) {
-            const MultiFab& vfrac = factory->getVolFrac();
-            for (int n=0; n < ncomp; ++n) {
-                MultiFab::Multiply(*pmf, vfrac, 0, n, 1, 0);
-            }
+            return &(factory->getVolFrac());
         } else {
-            amrex::Abort("MLMG::ResNormInf: not EB Factory");
+            amrex::Abort("MLMG::normVolFrac: not EB Factory");
         }
     }
+#else
+    amrex::ignore_unused(alev);
 #endif
-    for (int n = 0; n < ncomp; n++)
-    {
-        Real newnorm = 0.0;
-        if (fine_mask[alev]) {
-            newnorm = pmf->norm0(*fine_mask[alev],n,0,true);
-        } else {
-            newnorm = pmf->norm0(n,0,true);
-        }
-        norm = std::max(norm, newnorm);
-    }
+    return nullptr;
+}
+
+// Compute single-level masked inf-norm of Residual (res).
+Real
+MLMG::ResNormInf (int alev, bool local)
+{
+    BL_PROFILE("MLMG::ResNormInf()");
+    const int mglev = 0;
+    Real norm = fused_norminf(res[alev][mglev], fine_mask[alev].get(), normVolFrac(alev));
     if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
     return norm;
 }
@@ -1079,34 +1103,11 @@ Real
 MLMG::MLRhsNormInf (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
-    const int ncomp = linop.getNComp();
     Real r = 0.0;
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
-        MultiFab* pmf = &(rhs[alev]);
-#ifdef AMREX_USE_EB
-        if (linop.isCellCentered() && scratch[alev]) {
-            pmf = scratch[alev].get();
-            MultiFab::Copy(*pmf, rhs[alev], 0, 0, ncomp, 0);
-            auto factory = dynamic_cast<EBFArrayBoxFactory const*>(linop.Factory(alev));
-            if (factory) {
-                const MultiFab& vfrac = factory->getVolFrac();
-                for (int n=0; n < ncomp; ++n) {
-                    MultiFab::Multiply(*pmf, vfrac, 0, n, 1, 0);
-                }
-            } else {
-                amrex::Abort("MLMG::MLRhsNormInf: not EB Factory");
-            }
-        }
-#endif
-        for (int n=0; n<ncomp; ++n)
-        {
-            if (alev < finest_amr_lev) {
-                r = std::max(r, pmf->norm0(*fine_mask[alev],n,0,true));
-            } else {
-                r = std::max(r, pmf->norm0(n,0,true));
-            }
-        }
+        const iMultiFab* mask = (alev < finest_amr_lev) ? fine_mask[alev].get() : nullptr;
+        r = std::max(r, fused_norminf(rhs[alev], mask, normVolFrac(alev)));
     }
     if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
     return r;
@@ -1304,23 +1305,6 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
 
     buildFineMask();
 
-    if (!solve_called)
-    {
-        scratch.resize(namrlevs);
-#ifdef AMREX_USE_EB
-        if (linop.isCellCentered()) {
-            for (int alev=0; alev < namrlevs; ++alev) {
-                if (rhs[alev].hasEBFabFactory()) {
-                    scratch[alev] = std::make_unique<MultiFab>(rhs[alev].boxArray(),
-                                                               rhs[alev].DistributionMap(),
-                                                               ncomp, 0, MFInfo(),
-                                                               *linop.Factory(alev));
-                }
-            }
-        }
-#endif
-    }
-
     if (linop.m_parent) {
         do_nsolve = false;  // no embedded N-Solve
     } else if (!linop.supportNSolve()) {
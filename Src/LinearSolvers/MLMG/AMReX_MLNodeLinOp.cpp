@@ -170,6 +170,18 @@ MLNodeLinOp::xdoty (int amrlev, int mglev, const MultiFab& x, const MultiFab& y,
     return result;
 }
 
+void
+MLNodeLinOp::xdotyNormInf (int amrlev, int mglev, int ndots,
+                           const MultiFab* const* x, const MultiFab* const* y,
+                           const MultiFab* r, Real* result) const
+{
+    amrex::ignore_unused(amrlev);
+    AMREX_ASSERT(amrlev==0);
+    AMREX_ASSERT(mglev+1==m_num_mg_levels[0] || mglev==0);
+    const auto& mask = (mglev+1 == m_num_mg_levels[0]) ? m_bottom_dot_mask : m_coarse_dot_mask;
+    fusedXdotyNormInf(ndots, x, y, r, &mask, result);
+}
+
 void
 MLNodeLinOp::applyInhomogNeumannTerm (int /*amrlev*/, MultiFab& /*rhs*/) const
 {
@@ -209,6 +209,22 @@ AmrLevelAdv::init (AmrLevel &old)
     FillPatch(old, S_new, 0, cur_time, Phi_Type, 0, NUM_STATE);
 }
 
+/**
+ * Initialize data on this level from another AmrLevelAdv (during regrid)
+ * after Amr::regrid has filled the new-time data.
+ */
+void
+AmrLevelAdv::initAfterRegridFill (AmrLevel &old)
+{
+    AmrLevelAdv* oldlev = (AmrLevelAdv*) &old;
+
+    Real dt_new    = parent->dtLevel(level);
+    Real cur_time  = oldlev->state[Phi_Type].curTime();
+    Real prev_time = oldlev->state[Phi_Type].prevTime();
+    Real dt_old    = cur_time - prev_time;
+    setTimeLevel(cur_time,dt_old,dt_new);
+}
+
 /**
  * Initialize data on this level after regridding if old level did not previously exist
  */
@@ -0,0 +1,349 @@
+/*
+ * Runs a three-level hierarchy with several state types, whose refined
+ * region moves, regridding every step, first with amr.async_regrid = 0
+ * and then with amr.async_regrid = 1.  The grids and the state data of
+ * every level must be the same, bitwise, at the end of the two runs.
+ * A third run with amr.async_regrid = 1 pretends that the AmrLevel class
+ * does not override initAfterRegridFill, so that init(old) is used.  A
+ * fourth run with amr.incremental_regrid = 1 checks that the boxes that
+ * stay on their process keep the FABs of their new-time data.
+ */
+
+#include <AMReX.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_PROB_AMR_F.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int num_state_types = 3;
+constexpr int state_ncomp[num_state_types] = {2, 1, 2};
+
+struct NullFill
+{
+    AMREX_GPU_DEVICE
+    void operator() (const IntVect& /*iv*/, Array4<Real> const& /*dest*/,
+                     const int /*dcomp*/, const int /*numcomp*/,
+                     GeometryData const& /*geom*/, const Real /*time*/,
+                     const BCRec* /*bcr*/, const int /*bcomp*/,
+                     const int /*orig_comp*/) const
+        {
+            // only extrapolation and reflection, which GpuBndryFuncFab does
+        }
+};
+
+void nullfill (Box const& bx, FArrayBox& data,
+               const int dcomp, const int numcomp,
+               Geometry const& geom, const Real time,
+               const Vector<BCRec>& bcr, const int bcomp,
+               const int scomp)
+{
+    GpuBndryFuncFab<NullFill> gpu_bndry_func(NullFill{});
+    gpu_bndry_func(bx,data,dcomp,numcomp,geom,time,bcr,bcomp,scomp);
+}
+
+// Relaxes mf towards a function of position and time
+void update_state (MultiFab& mf, MultiFab const& old, Geometry const& geom, int type, Real time)
+{
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        auto const& o = old.const_array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real r = type + Real(0.25)*n;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = plo[idim] + (iv[idim] + Real(0.5))*dx[idim] - time;
+                r += std::sin(Real(6.2831853071795865)*(idim+n+type+1)*x);
+            }
+            a(i,j,k,n) = Real(0.5)*(o(i,j,k,n) + r);
+        });
+    }
+}
+
+int num_init_after_regrid_fill = 0;
+bool has_init_after_regrid_fill = true;
+bool incremental_regrid = false;
+Long num_kept_fabs = 0;
+
+}
+
+class RegridLevel
+    : public AmrLevel
+{
+public:
+
+    RegridLevel () = default;
+
+    RegridLevel (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+                 const DistributionMapping& dm, Real time)
+        : AmrLevel(papa, lev, level_geom, ba, dm, time)
+    {
+        // The coarser level is already the new one.
+        AMREX_ALWAYS_ASSERT(lev == 0 || papa.getLevel(lev-1).boxArray().contains(
+                                amrex::coarsen(ba, papa.refRatio(lev-1))));
+    }
+
+    static void variableSetUp ()
+    {
+        BCRec bc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, DefaultGeometry().isPeriodic(idim) ? BCType::int_dir : BCType::foextrap);
+            bc.setHi(idim, DefaultGeometry().isPeriodic(idim) ? BCType::int_dir : BCType::reflect_even);
+        }
+        StateDescriptor::BndryFunc bndryfunc(nullfill);
+        bndryfunc.setRunOnGPU(true);
+
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               state_ncomp[0], &cell_cons_interp);
+        desc_lst.setComponent(0, 0, "a0", bc, bndryfunc);
+        desc_lst.setComponent(0, 1, "a1", bc, bndryfunc);
+
+        desc_lst.addDescriptor(1, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               state_ncomp[1], &pc_interp);
+        desc_lst.setComponent(1, 0, "b0", bc, bndryfunc);
+
+        desc_lst.addDescriptor(2, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               state_ncomp[2], &cell_cons_interp);
+        desc_lst.setComponent(2, 0, "c0", bc, bndryfunc, &cell_bilinear_interp);
+        desc_lst.setComponent(2, 1, "c1", bc, bndryfunc, &pc_interp);
+    }
+
+    static void variableCleanUp () { desc_lst.clear(); }
+
+    void initData () override
+    {
+        for (int type = 0; type < num_state_types; ++type) {
+            MultiFab& S_new = get_new_data(type);
+            S_new.setVal(0.0);
+            update_state(S_new, S_new, geom, type, 0.0);
+        }
+    }
+
+    // Tags a shell whose center moves with time
+    void errorEst (TagBoxArray& tags, int, int, Real time, int, int) override
+    {
+        const auto plo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        const Real w = Real(0.06) - Real(0.02)*level;
+        const Real center = Real(0.4) + time;
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            auto const& tag = tags.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                Real r2 = 0.0;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    Real x = plo[idim] + (iv[idim] + Real(0.5))*dx[idim] - center;
+                    r2 += x*x;
+                }
+                if (std::abs(std::sqrt(r2) - Real(0.25)) < w) {
+                    tag(i,j,k) = TagBox::SET;
+                }
+            });
+        }
+    }
+
+    void init (AmrLevel& old) override
+    {
+        setTimeLevelFrom(old);
+        for (int type = 0; type < num_state_types; ++type) {
+            FillPatch(old, get_new_data(type), 0, old.get_state_data(type).curTime(), type,
+                      0, state_ncomp[type]);
+        }
+    }
+
+    void initAfterRegridFill (AmrLevel& old) override
+    {
+        ++num_init_after_regrid_fill;
+        setTimeLevelFrom(old);
+
+        // The boxes that stay on their process have the FABs of old.
+        auto const& old_ptrs = static_cast<RegridLevel&>(old).m_new_data_ptrs;
+        if (!incremental_regrid || old_ptrs.empty()) return;
+        const Vector<int> old_index = amrex::SameBoxIndices(grids, dmap, old.boxArray(),
+                                                            old.DistributionMap());
+        for (int type = 0; type < num_state_types; ++type) {
+            for (MFIter mfi(get_new_data(type)); mfi.isValid(); ++mfi) {
+                const int k = old_index[mfi.index()];
+                if (k >= 0) {
+                    AMREX_ALWAYS_ASSERT(get_new_data(type)[mfi].dataPtr() == old_ptrs[type][k]);
+                    ++num_kept_fabs;
+                }
+            }
+        }
+    }
+
+    bool hasInitAfterRegridFill () const override { return has_init_after_regrid_fill; }
+
+    void init () override
+    {
+        const Real cur_time = parent->getLevel(level-1).get_state_data(0).curTime();
+        const Real prev_time = parent->getLevel(level-1).get_state_data(0).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, parent->dtLevel(level));
+        for (int type = 0; type < num_state_types; ++type) {
+            FillCoarsePatch(get_new_data(type), 0, cur_time, type, 0, state_ncomp[type]);
+        }
+    }
+
+    void computeInitialDt (int, int, Vector<int>&, const Vector<IntVect>&,
+                           Vector<Real>& dt_level, Real) override
+    {
+        for (auto& dt : dt_level) { dt = Real(0.05); }
+    }
+    void computeNewDt (int, int, Vector<int>&, const Vector<IntVect>&,
+                       Vector<Real>& dt_min, Vector<Real>& dt_level, Real, int) override
+    {
+        for (auto& dt : dt_min) { dt = Real(0.05); }
+        for (auto& dt : dt_level) { dt = Real(0.05); }
+    }
+
+    Real advance (Real time, Real dt, int, int) override
+    {
+        for (int type = 0; type < num_state_types; ++type) {
+            state[type].allocOldData();
+            state[type].swapTimeLevels(dt);
+            update_state(get_new_data(type), get_old_data(type), geom, type, time+dt);
+        }
+        m_new_data_ptrs.assign(num_state_types, Vector<const Real*>(grids.size(), nullptr));
+        for (int type = 0; type < num_state_types; ++type) {
+            for (MFIter mfi(get_new_data(type)); mfi.isValid(); ++mfi) {
+                m_new_data_ptrs[type][mfi.index()] = get_new_data(type)[mfi].dataPtr();
+            }
+        }
+        return dt;
+    }
+
+    void post_timestep (int) override {}
+    void post_regrid (int, int) override {}
+    void post_init (Real) override {}
+
+private:
+
+    // The local FABs of the new-time data after the last advance
+    Vector<Vector<const Real*> > m_new_data_ptrs;
+
+    void setTimeLevelFrom (AmrLevel& old)
+    {
+        const Real cur_time = old.get_state_data(0).curTime();
+        const Real prev_time = old.get_state_data(0).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, parent->dtLevel(level));
+    }
+};
+
+class RegridLevelBld
+    : public LevelBld
+{
+    void variableSetUp () override { RegridLevel::variableSetUp(); }
+    void variableCleanUp () override { RegridLevel::variableCleanUp(); }
+    AmrLevel* operator() () override { return new RegridLevel; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+                          const DistributionMapping& dm, Real time) override
+    {
+        return new RegridLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+RegridLevelBld regrid_level_bld;
+
+extern "C" {
+    void amrex_probinit (const int* /*init*/, const int* /*name*/, const int* /*namelen*/,
+                         const amrex_real* /*problo*/, const amrex_real* /*probhi*/)
+    {}
+}
+
+// The state data of every level after nsteps steps
+Vector<Vector<MultiFab> > run (int async, int incremental, int nsteps)
+{
+    ParmParse pp("amr");
+    pp.add("async_regrid", async);
+    pp.add("incremental_regrid", incremental);
+    incremental_regrid = incremental;
+
+    Amr amr(&regrid_level_bld);
+    amr.init(0.0, 1.0);
+    for (int step = 0; step < nsteps; ++step) {
+        amr.coarseTimeStep(1.0);
+    }
+    AMREX_ALWAYS_ASSERT(amr.finestLevel() == 2);
+
+    Vector<Vector<MultiFab> > r(amr.finestLevel()+1);
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        for (int type = 0; type < num_state_types; ++type) {
+            MultiFab const& S_new = amr.getLevel(lev).get_new_data(type);
+            r[lev].emplace_back(S_new.boxArray(), S_new.DistributionMap(), S_new.nComp(), 0);
+            MultiFab::Copy(r[lev].back(), S_new, 0, 0, S_new.nComp(), 0);
+        }
+    }
+    return r;
+}
+
+void main_main ()
+{
+    int nsteps = 6;
+    {
+        ParmParse pp;
+        pp.query("nsteps", nsteps);
+    }
+
+    auto sync = run(0, 0, nsteps);
+    AMREX_ALWAYS_ASSERT(num_init_after_regrid_fill == 0);
+
+    auto async = run(1, 0, nsteps);
+    const int num_filled = num_init_after_regrid_fill;
+    AMREX_ALWAYS_ASSERT(num_filled > 0);
+
+    has_init_after_regrid_fill = false;
+    auto fallback = run(1, 0, nsteps);
+    AMREX_ALWAYS_ASSERT(num_init_after_regrid_fill == num_filled);
+
+    has_init_after_regrid_fill = true;
+    auto incremental = run(0, 1, nsteps);
+    AMREX_ALWAYS_ASSERT(num_init_after_regrid_fill == 2*num_filled);
+    ParallelDescriptor::ReduceLongSum(num_kept_fabs);
+    AMREX_ALWAYS_ASSERT(num_kept_fabs > 0);
+
+    AMREX_ALWAYS_ASSERT(sync.size() == async.size() && sync.size() == fallback.size()
+                        && sync.size() == incremental.size());
+    for (int lev = 0; lev < sync.size(); ++lev) {
+        for (int type = 0; type < num_state_types; ++type) {
+            MultiFab& s = sync[lev][type];
+            for (auto const& other : {std::make_pair(&async, "async"),
+                                      std::make_pair(&fallback, "fallback"),
+                                      std::make_pair(&incremental, "incremental")}) {
+                MultiFab& a = (*other.first)[lev][type];
+                AMREX_ALWAYS_ASSERT(s.boxArray() == a.boxArray());
+                // The processes of the boxes may differ.
+                MultiFab d(s.boxArray(), s.DistributionMap(), s.nComp(), 0);
+                d.ParallelCopy(a);
+                MultiFab::Subtract(d, s, 0, 0, s.nComp(), 0);
+                Real diff = 0.0;
+                for (int n = 0; n < s.nComp(); ++n) {
+                    diff = std::max(diff, d.norm0(n));
+                }
+                amrex::Print() << "Level " << lev << ", state type " << type << ", "
+                               << other.second << ": "
+                               << s.boxArray().size() << " grids, difference " << diff << std::endl;
+                AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+            }
+        }
+    }
+    amrex::Print() << num_filled << " levels filled by the async regrid, "
+                   << num_kept_fabs << " FABs kept by the incremental regrid" << std::endl;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
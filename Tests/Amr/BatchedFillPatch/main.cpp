@@ -0,0 +1,280 @@
+/*
+ * Fills several state types of a three-level, partly periodic hierarchy
+ * with the batched FillPatchIterator, at the old, new and an intermediate
+ * time, and with several numbers of ghost cells.  The results must be
+ * bitwise identical to those of one FillPatchIterator per state type.
+ * With fabarray.cache_fillpatch_data = 1, repeated batched fills must give
+ * the same results without building any new copy plans.
+ */
+
+#include <AMReX.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_PROB_AMR_F.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+
+using namespace amrex;
+
+namespace {
+
+// State types "a" with two components, "b" with one, and "c" with two
+// components that use different interpolaters
+constexpr int num_state_types = 3;
+constexpr int state_ncomp[num_state_types] = {2, 1, 2};
+
+struct NullFill
+{
+    AMREX_GPU_DEVICE
+    void operator() (const IntVect& /*iv*/, Array4<Real> const& /*dest*/,
+                     const int /*dcomp*/, const int /*numcomp*/,
+                     GeometryData const& /*geom*/, const Real /*time*/,
+                     const BCRec* /*bcr*/, const int /*bcomp*/,
+                     const int /*orig_comp*/) const
+        {
+            // only extrapolation and reflection, which GpuBndryFuncFab does
+        }
+};
+
+void nullfill (Box const& bx, FArrayBox& data,
+               const int dcomp, const int numcomp,
+               Geometry const& geom, const Real time,
+               const Vector<BCRec>& bcr, const int bcomp,
+               const int scomp)
+{
+    GpuBndryFuncFab<NullFill> gpu_bndry_func(NullFill{});
+    gpu_bndry_func(bx,data,dcomp,numcomp,geom,time,bcr,bcomp,scomp);
+}
+
+void init_state (MultiFab& mf, Geometry const& geom, int type, Real offset)
+{
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real r = offset + type + Real(0.25)*n;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = plo[idim] + (iv[idim] + Real(0.5))*dx[idim];
+                r += std::sin(Real(6.2831853071795865)*(idim+n+type+1)*x);
+            }
+            a(i,j,k,n) = r;
+        });
+    }
+}
+
+}
+
+class FillLevel
+    : public AmrLevel
+{
+public:
+
+    FillLevel () = default;
+
+    FillLevel (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+               const DistributionMapping& dm, Real time)
+        : AmrLevel(papa, lev, level_geom, ba, dm, time)
+    {}
+
+    static void variableSetUp ()
+    {
+        BCRec bc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, DefaultGeometry().isPeriodic(idim) ? BCType::int_dir : BCType::foextrap);
+            bc.setHi(idim, DefaultGeometry().isPeriodic(idim) ? BCType::int_dir : BCType::reflect_even);
+        }
+        StateDescriptor::BndryFunc bndryfunc(nullfill);
+        bndryfunc.setRunOnGPU(true);
+
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               state_ncomp[0], &cell_cons_interp);
+        desc_lst.setComponent(0, 0, "a0", bc, bndryfunc);
+        desc_lst.setComponent(0, 1, "a1", bc, bndryfunc);
+
+        desc_lst.addDescriptor(1, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               state_ncomp[1], &pc_interp);
+        desc_lst.setComponent(1, 0, "b0", bc, bndryfunc);
+
+        desc_lst.addDescriptor(2, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               state_ncomp[2], &cell_cons_interp);
+        desc_lst.setComponent(2, 0, "c0", bc, bndryfunc, &cell_bilinear_interp);
+        desc_lst.setComponent(2, 1, "c1", bc, bndryfunc, &pc_interp);
+    }
+
+    static void variableCleanUp () { desc_lst.clear(); }
+
+    void initData () override
+    {
+        for (int type = 0; type < num_state_types; ++type) {
+            init_state(get_new_data(type), geom, type, 0.0);
+        }
+    }
+
+    // Tags a block in the interior and one at the non-periodic boundary
+    void errorEst (TagBoxArray& tags, int, int, Real, int, int) override
+    {
+        const auto plo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        const int lev = level;
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            auto const& tag = tags.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                Real x[AMREX_SPACEDIM];
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    x[idim] = plo[idim] + (iv[idim] + Real(0.5))*dx[idim];
+                }
+                const Real w = Real(0.2) - Real(0.05)*lev;
+                bool inner = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    inner = inner && std::abs(x[idim] - Real(0.45)) < w;
+                }
+                const bool edge = x[1] < w && x[0] > Real(0.7) && x[0] < Real(0.7) + w;
+                if (inner || edge) {
+                    tag(i,j,k) = TagBox::SET;
+                }
+            });
+        }
+    }
+
+    void init (AmrLevel&) override { amrex::Abort("FillLevel: no regrid"); }
+    void init () override { amrex::Abort("FillLevel: no regrid"); }
+    void computeInitialDt (int, int, Vector<int>&, const Vector<IntVect>&,
+                           Vector<Real>& dt_level, Real) override
+    {
+        for (auto& dt : dt_level) { dt = Real(0.5); }
+    }
+    void computeNewDt (int, int, Vector<int>&, const Vector<IntVect>&,
+                       Vector<Real>& dt_min, Vector<Real>& dt_level, Real, int) override
+    {
+        for (auto& dt : dt_min) { dt = Real(0.5); }
+        for (auto& dt : dt_level) { dt = Real(0.5); }
+    }
+    Real advance (Real, Real dt, int, int) override { return dt; }
+    void post_timestep (int) override {}
+    void post_regrid (int, int) override {}
+    void post_init (Real) override {}
+};
+
+class FillLevelBld
+    : public LevelBld
+{
+    void variableSetUp () override { FillLevel::variableSetUp(); }
+    void variableCleanUp () override { FillLevel::variableCleanUp(); }
+    AmrLevel* operator() () override { return new FillLevel; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+                          const DistributionMapping& dm, Real time) override
+    {
+        return new FillLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+FillLevelBld fill_level_bld;
+
+extern "C" {
+    void amrex_probinit (const int* /*init*/, const int* /*name*/, const int* /*namelen*/,
+                         const amrex_real* /*problo*/, const amrex_real* /*probhi*/)
+    {}
+}
+
+void main_main ()
+{
+    Vector<int> nghosts{1, 2, 4};
+    {
+        ParmParse pp;
+        pp.queryarr("nghost", nghosts);
+    }
+
+    Amr amr(&fill_level_bld);
+    amr.init(0.0, 1.0);
+    AMREX_ALWAYS_ASSERT(amr.finestLevel() == 2);
+
+    // Old data at t = 0.5 and new data at t = 1, which differ
+    const Real t_old = 0.5, t_new = 1.0;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        AmrLevel& level = amr.getLevel(lev);
+        level.allocOldData();
+        level.setTimeLevel(t_new, t_new-t_old, t_new-t_old);
+        for (int type = 0; type < num_state_types; ++type) {
+            init_state(level.get_new_data(type), level.Geom(), type, 0.0);
+            init_state(level.get_old_data(type), level.Geom(), type, 1.0);
+        }
+    }
+
+    // Non-contiguous and repeated components, in a different order than the
+    // state types
+    const Vector<int> idx  {2, 0, 1, 0};
+    const Vector<int> scomp{0, 1, 0, 0};
+    const Vector<int> ncomp{2, 1, 1, 2};
+
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        AmrLevel& level = amr.getLevel(lev);
+        MultiFab& leveldata = level.get_new_data(0);
+        for (int ng : nghosts) {
+            for (Real time : {t_old, t_new, Real(0.5)*(t_old+t_new)}) {
+                FillPatchIterator batched(level, leveldata, ng, time, idx, scomp, ncomp);
+                MultiFab& bmf = batched.get_mf();
+
+                Real diff = 0.0;
+                for (int i = 0, dcomp = 0; i < idx.size(); dcomp += ncomp[i], ++i) {
+                    FillPatchIterator single(level, leveldata, ng, time, idx[i], scomp[i], ncomp[i]);
+                    MultiFab& smf = single.get_mf();
+                    MultiFab d(smf.boxArray(), smf.DistributionMap(), ncomp[i], ng);
+                    MultiFab::Copy(d, bmf, dcomp, 0, ncomp[i], ng);
+                    MultiFab::Subtract(d, smf, 0, 0, ncomp[i], ng);
+                    for (int n = 0; n < ncomp[i]; ++n) {
+                        diff = std::max(diff, d.norm0(n, ng));
+                    }
+                }
+                amrex::Print() << "Level " << lev << ", " << ng << " ghost cells, time "
+                               << time << ": difference " << diff << std::endl;
+                AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+            }
+        }
+    }
+
+    const int ng = nghosts.back();
+    const Real time = Real(0.5)*(t_old+t_new);
+    for (int lev = 1; lev <= amr.finestLevel(); ++lev) {
+        AmrLevel& level = amr.getLevel(lev);
+        MultiFab& leveldata = level.get_new_data(0);
+
+        FabArrayBase::cache_fillpatch_data = false;
+        FillPatchIterator ref(level, leveldata, ng, time, idx, scomp, ncomp);
+        MultiFab& rmf = ref.get_mf();
+
+        FabArrayBase::cache_fillpatch_data = true;
+        Long nbuild = 0;
+        for (int icall = 0; icall < 3; ++icall) {
+            if (icall == 1) { nbuild = FabArrayBase::m_CPC_stats.nbuild; }
+            FillPatchIterator batched(level, leveldata, ng, time, idx, scomp, ncomp);
+            MultiFab& bmf = batched.get_mf();
+            MultiFab d(bmf.boxArray(), bmf.DistributionMap(), bmf.nComp(), ng);
+            MultiFab::Copy(d, bmf, 0, 0, bmf.nComp(), ng);
+            MultiFab::Subtract(d, rmf, 0, 0, bmf.nComp(), ng);
+            Real diff = 0.0;
+            for (int n = 0; n < bmf.nComp(); ++n) {
+                diff = std::max(diff, d.norm0(n, ng));
+            }
+            amrex::Print() << "Level " << lev << ", kept patches, call " << icall
+                           << ": difference " << diff << std::endl;
+            AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+        }
+        AMREX_ALWAYS_ASSERT(FabArrayBase::m_CPC_stats.nbuild == nbuild);
+        FabArrayBase::cache_fillpatch_data = false;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
@@ -0,0 +1,211 @@
+/*
+ * Fills the ghost cells of two-level cell- and face-centered data with
+ * FillPatchTwoLevels, repeatedly, with fabarray.cache_fillpatch_data = 1.
+ * Every call must give results that are bitwise identical to those
+ * without the cache, and the cached FPinfo must account for the memory
+ * of the patches it keeps.
+ */
+
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void init_data (MultiFab& mf, Geometry const& geom, Real offset)
+{
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = mf.ixType().toIntVect();
+    const int ncomp = mf.nComp();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real r = offset + n;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = plo[idim] + (iv[idim] + 0.5*(1-nodal[idim]))*dx[idim];
+                r += std::sin(6.2831853071795865*(idim+1)*x);
+            }
+            a(i,j,k,n) = r;
+        });
+    }
+}
+
+// Largest difference between a and b, including ghost cells
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    const IntVect ng = a.nGrowVect();
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), ng);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), ng);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), ng);
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norm0(n, ng.max(), true));
+    }
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+// Local bytes of the coarse and fine patches of fpc with ncomp components
+Long patch_bytes (FabArrayBase::FPinfo const& fpc, int ncomp)
+{
+    Long n = 0;
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0; i < fpc.ba_crse_patch.size(); ++i) {
+        if (fpc.dm_patch[i] == myproc) {
+            n += (fpc.ba_crse_patch[i].numPts() + fpc.ba_fine_patch[i].numPts())
+                * ncomp * Long(sizeof(Real));
+        }
+    }
+    return n;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    int ncomp = 2;
+    int ncalls = 3;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("ncomp", ncomp);
+        pp.query("ncalls", ncalls);
+    }
+
+    // Set by fabarray.cache_fillpatch_data in the inputs
+    AMREX_ALWAYS_ASSERT(FabArrayBase::cache_fillpatch_data);
+
+    const IntVect ratio(2);
+    const IntVect nghost(2);
+
+    Box cdomain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+    Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+    Geometry fgeom(amrex::refine(cdomain, ratio), rb, CoordSys::cartesian, is_periodic);
+
+    BoxArray cba(cdomain);
+    cba.maxSize(max_grid_size);
+    DistributionMapping cdm(cba);
+
+    // Two disjoint refined regions, one of them touching the domain boundary
+    BoxList fbl;
+    fbl.push_back(amrex::refine(Box(IntVect(AMREX_D_DECL(n_cell/8, n_cell/8, n_cell/8)),
+                                    IntVect(AMREX_D_DECL(n_cell/2+3, n_cell/2-1, n_cell/2-1))),
+                                ratio));
+    fbl.push_back(amrex::refine(Box(IntVect(AMREX_D_DECL(n_cell/2+4, n_cell/2, 0)),
+                                    IntVect(AMREX_D_DECL(n_cell-1, 3*n_cell/4-1, n_cell/4-1))),
+                                ratio));
+    BoxArray fba(std::move(fbl));
+    fba.maxSize(max_grid_size);
+    DistributionMapping fdm(fba);
+
+    Vector<BCRec> bcs(ncomp);
+    for (auto& bc : bcs) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, BCType::int_dir);
+            bc.setHi(idim, BCType::int_dir);
+        }
+    }
+    PhysBCFunctNoOp phys_bc;
+    Array<PhysBCFunctNoOp, AMREX_SPACEDIM> face_phys_bc;
+    Array<Vector<BCRec>, AMREX_SPACEDIM> face_bcs;
+    for (auto& b : face_bcs) { b = bcs; }
+
+    // Cell-centered data
+    MultiFab crse(cba, cdm, ncomp, 0);
+    MultiFab fine(fba, fdm, ncomp, 0);
+    MultiFab dst(fba, fdm, ncomp, nghost);
+    init_data(crse, cgeom, 0.0);
+    init_data(fine, fgeom, 0.5);
+
+    // Face-centered data
+    Array<MultiFab, AMREX_SPACEDIM> fcrse, ffine, fdst;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const IntVect ix = IntVect::TheDimensionVector(idim);
+        fcrse[idim].define(amrex::convert(cba, ix), cdm, ncomp, 0);
+        ffine[idim].define(amrex::convert(fba, ix), fdm, ncomp, 0);
+        fdst[idim].define(amrex::convert(fba, ix), fdm, ncomp, nghost);
+        init_data(fcrse[idim], cgeom, 0.0);
+        init_data(ffine[idim], fgeom, 0.5);
+    }
+
+    auto fill = [&] (MultiFab& result, Array<MultiFab, AMREX_SPACEDIM>& face_result)
+    {
+        dst.setVal(-1.e30);
+        FillPatchTwoLevels(dst, nghost, 0.0, {&crse}, {0.0}, {&fine}, {0.0},
+                           0, 0, ncomp, cgeom, fgeom, phys_bc, 0, phys_bc, 0,
+                           ratio, &cell_cons_interp, bcs, 0);
+        result.define(dst.boxArray(), dst.DistributionMap(), ncomp, nghost);
+        MultiFab::Copy(result, dst, 0, 0, ncomp, nghost);
+
+        Array<MultiFab*, AMREX_SPACEDIM> fdst_p, fcrse_p, ffine_p;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            fdst[idim].setVal(-1.e30);
+            fdst_p[idim] = &fdst[idim];
+            fcrse_p[idim] = &fcrse[idim];
+            ffine_p[idim] = &ffine[idim];
+        }
+        FillPatchTwoLevels(fdst_p, nghost, 0.0, {fcrse_p}, {0.0}, {ffine_p}, {0.0},
+                           0, 0, ncomp, cgeom, fgeom, face_phys_bc, 0, face_phys_bc, 0,
+                           ratio, &face_linear_interp, face_bcs, 0);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            face_result[idim].define(fdst[idim].boxArray(), fdst[idim].DistributionMap(),
+                                     ncomp, nghost);
+            MultiFab::Copy(face_result[idim], fdst[idim], 0, 0, ncomp, nghost);
+        }
+    };
+
+    auto const& coarsener = cell_cons_interp.BoxCoarsener(ratio);
+
+    // Reference without the cache
+    FabArrayBase::cache_fillpatch_data = false;
+    MultiFab ref;
+    Array<MultiFab, AMREX_SPACEDIM> face_ref;
+    fill(ref, face_ref);
+    const auto* fpc = &FabArrayBase::TheFPinfo(fine, dst, nghost, coarsener, fgeom, cgeom, nullptr);
+    AMREX_ALWAYS_ASSERT(fpc->patchBytes() == 0);
+    AMREX_ALWAYS_ASSERT(!fpc->ba_crse_patch.empty());
+
+    FabArrayBase::cache_fillpatch_data = true;
+    for (int icall = 0; icall < ncalls; ++icall)
+    {
+        MultiFab result;
+        Array<MultiFab, AMREX_SPACEDIM> face_result;
+        fill(result, face_result);
+
+        Real diff = max_diff(result, ref);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            diff = std::max(diff, max_diff(face_result[idim], face_ref[idim]));
+        }
+        amrex::Print() << "Call " << icall << ": difference from the uncached results "
+                       << diff << std::endl;
+        AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+
+        // The same FPinfo, which now holds the patches
+        const auto* fpc_cached = &FabArrayBase::TheFPinfo(fine, dst, nghost, coarsener,
+                                                          fgeom, cgeom, nullptr);
+        AMREX_ALWAYS_ASSERT(fpc_cached == fpc);
+        AMREX_ALWAYS_ASSERT(fpc->patchBytes() >= patch_bytes(*fpc, ncomp));
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ * Checks that AmrCore::LoadBalance only installs a new
+ * DistributionMapping when the measured cost promises an efficiency
+ * gain above the threshold, and that the data move with the boxes.
+ */
+
+#include <AMReX.H>
+#include <AMReX_AmrCore.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+class LoadBalanceTest
+    : public AmrCore
+{
+public:
+
+    LoadBalanceTest () { m_data.resize(maxLevel()+1); }
+
+    void ErrorEst (int, TagBoxArray&, Real, int) override {}
+
+    void MakeNewLevelFromScratch (int lev, Real, const BoxArray& ba, const DistributionMapping& dm) override
+    {
+        m_data[lev].define(ba, dm, 1, 0);
+        for (MFIter mfi(m_data[lev]); mfi.isValid(); ++mfi) {
+            m_data[lev][mfi].setVal<RunOn::Host>(Real(mfi.index()));
+        }
+    }
+
+    void MakeNewLevelFromCoarse (int, Real, const BoxArray&, const DistributionMapping&) override
+    {
+        amrex::Abort("LoadBalanceTest: no fine levels");
+    }
+
+    void RemakeLevel (int lev, Real, const BoxArray& ba, const DistributionMapping& dm) override
+    {
+        AMREX_ALWAYS_ASSERT(ba == boxArray(lev));
+        ++m_nremake;
+        MultiFab mf(ba, dm, 1, 0);
+        mf.ParallelCopy(m_data[lev]);
+        std::swap(mf, m_data[lev]);
+    }
+
+    void ClearLevel (int lev) override { m_data[lev].clear(); }
+
+    // Every box still holds its own index.
+    bool dataMoved (int lev) const
+    {
+        Real err = 0;
+        for (MFIter mfi(m_data[lev]); mfi.isValid(); ++mfi) {
+            const auto mm = m_data[lev][mfi].minmax<RunOn::Host>(mfi.validbox(), 0);
+            err = std::max(err, std::max(std::abs(mm.first  - Real(mfi.index())),
+                                         std::abs(mm.second - Real(mfi.index()))));
+        }
+        ParallelDescriptor::ReduceRealMax(err);
+        return err == Real(0);
+    }
+
+    int m_nremake = 0;
+
+private:
+    Vector<MultiFab> m_data;
+};
+
+namespace {
+
+// Rank 0's boxes cost heavy, all others cost 1.
+void set_cost (LayoutData<Real>& cost, Real heavy)
+{
+    for (MFIter mfi(cost); mfi.isValid(); ++mfi) {
+        cost[mfi] = (cost.DistributionMap()[mfi.index()] == 0) ? heavy : Real(1);
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        LoadBalanceTest amr;
+        amr.InitFromScratch(0.0);
+        AMREX_ALWAYS_ASSERT(amr.boxArray(0).size() >= 2*ParallelDescriptor::NProcs());
+
+        const BoxArray ba = amr.boxArray(0);
+        const DistributionMapping dm0 = amr.DistributionMap(0);
+
+        {
+            // The measured cost of a loop goes to the boxes that were visited.
+            LayoutData<Real> cost(ba, dm0);
+            set_cost(cost, Real(0));
+            for (MFIter mfi(cost, MFItInfo().MeasureCost(cost)); mfi.isValid(); ++mfi) {
+                volatile Real s = 0;
+                for (int i = 0; i < 100000; ++i) { s = s + Real(i); }
+            }
+            for (MFIter mfi(cost); mfi.isValid(); ++mfi) {
+                AMREX_ALWAYS_ASSERT(cost[mfi] > Real(0));
+            }
+        }
+
+        {
+            // A balanced cost never triggers a remap.
+            LayoutData<Real> cost(ba, dm0);
+            set_cost(cost, Real(1));
+            Real eff;
+            DistributionMapping::ComputeDistributionMappingEfficiency(cost, &eff);
+            AMREX_ALWAYS_ASSERT(eff > Real(0.9));
+            AMREX_ALWAYS_ASSERT(!amr.LoadBalance(0, 0.0, cost, Real(0.1)));
+            AMREX_ALWAYS_ASSERT(amr.DistributionMap(0) == dm0 && amr.m_nremake == 0);
+            amrex::Print() << "balanced cost: efficiency " << eff << ", kept" << std::endl;
+        }
+
+        if (ParallelDescriptor::NProcs() > 1)
+        {
+            LayoutData<Real> cost(ba, dm0);
+            set_cost(cost, Real(100));
+            Real eff;
+            DistributionMapping::ComputeDistributionMappingEfficiency(cost, &eff);
+            AMREX_ALWAYS_ASSERT(eff < Real(0.6));
+
+            // The gain does not exceed a large threshold ...
+            AMREX_ALWAYS_ASSERT(!amr.LoadBalance(0, 0.0, cost, Real(10.)));
+            AMREX_ALWAYS_ASSERT(amr.DistributionMap(0) == dm0 && amr.m_nremake == 0);
+            amrex::Print() << "skewed cost: efficiency " << eff << ", kept with threshold 10" << std::endl;
+
+            // ... but it does exceed a small one.
+            AMREX_ALWAYS_ASSERT(amr.LoadBalance(0, 0.0, cost, Real(0.1)));
+            AMREX_ALWAYS_ASSERT(amr.DistributionMap(0) != dm0 && amr.m_nremake == 1);
+            AMREX_ALWAYS_ASSERT(amr.boxArray(0) == ba);
+            AMREX_ALWAYS_ASSERT(amr.dataMoved(0));
+
+            // The same cost on the new map is balanced.
+            const DistributionMapping& dm1 = amr.DistributionMap(0);
+            LayoutData<Real> newcost(ba, dm1);
+            for (MFIter mfi(newcost); mfi.isValid(); ++mfi) {
+                newcost[mfi] = (dm0[mfi.index()] == 0) ? Real(100) : Real(1);
+            }
+            DistributionMapping::ComputeDistributionMappingEfficiency(newcost, &eff);
+            amrex::Print() << "skewed cost: redistributed with threshold 0.1, new efficiency "
+                           << eff << std::endl;
+            AMREX_ALWAYS_ASSERT(eff > Real(0.9));
+            AMREX_ALWAYS_ASSERT(!amr.LoadBalance(0, 0.0, newcost, Real(0.1)));
+            AMREX_ALWAYS_ASSERT(amr.m_nremake == 1);
+        }
+    }
+    amrex::Finalize();
+}
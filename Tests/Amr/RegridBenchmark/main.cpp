@@ -0,0 +1,287 @@
+/*
+ * Times AmrMesh::MakeNewGrids with the serial clustering on the I/O
+ * process and with the distributed clustering, for tags on a spherical
+ * shell that moves with time.  For each mode it reports the time per
+ * regrid, the number of fine grids and the fraction of the fine cells
+ * that are tagged, and checks that the fine grids are disjoint and cover
+ * all tags.
+ *
+ * It then times AmrCore::regrid, which copies the fine data to the new
+ * grids, with and without the incremental regrid, and reports the number
+ * of fine cells copied between processes.  With the incremental regrid,
+ * the grids that have not changed must stay on their processes and keep
+ * their FABs, which RemakeLevel does with RemakeFabArray, and no more cells
+ * may be copied between processes than without it.
+ */
+
+#include <AMReX.H>
+#include <AMReX_AmrCore.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_TagBox.H>
+
+using namespace amrex;
+
+class RegridBenchmark
+    : public AmrCore
+{
+public:
+
+    RegridBenchmark ()
+    {
+        ParmParse pp("regrid");
+        pp.query("radius", m_radius);
+        pp.query("width", m_width);
+        pp.query("speed", m_speed);
+        pp.query("ncomp", m_ncomp);
+        m_data.resize(maxLevel()+1);
+    }
+
+    void setDistributedClustering (bool flag) { SetUseDistributedClustering(flag); }
+    void setIncrementalRegrid (bool flag) { SetUseIncrementalRegrid(flag); m_incremental = flag; }
+
+    MultiFab const& data (int lev) const { return m_data[lev]; }
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real time, int /*ngrow*/) override
+    {
+        const auto problo = Geom(lev).ProbLoArray();
+        const auto dx = Geom(lev).CellSizeArray();
+        const Real center = Real(0.5) + m_speed*time;
+        const Real rlo = m_radius - Real(0.5)*m_width;
+        const Real rhi = m_radius + Real(0.5)*m_width;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(tags,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            auto const& tag = tags.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                Real r2 = 0.0;
+                IntVect iv(AMREX_D_DECL(i,j,k));
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    Real x = problo[idim] + (iv[idim]+Real(0.5))*dx[idim] - center;
+                    r2 += x*x;
+                }
+                if (r2 >= rlo*rlo && r2 <= rhi*rhi) {
+                    tag(i,j,k) = TagBox::SET;
+                }
+            });
+        }
+    }
+
+    void MakeNewLevelFromScratch (int lev, Real, const BoxArray& ba, const DistributionMapping& dm) override
+    {
+        m_data[lev].define(ba, dm, m_ncomp, 0);
+        m_data[lev].setVal(Real(lev));
+    }
+
+    void MakeNewLevelFromCoarse (int lev, Real time, const BoxArray& ba, const DistributionMapping& dm) override
+    {
+        MakeNewLevelFromScratch(lev, time, ba, dm);
+    }
+
+    void RemakeLevel (int lev, Real, const BoxArray& ba, const DistributionMapping& dm) override
+    {
+        auto fill = [&] (MultiFab& mf)
+        {
+            mf.setVal(Real(lev));
+            mf.ParallelCopy(m_data[lev]);
+        };
+        if (m_incremental) {
+            amrex::RemakeFabArray(m_data[lev], ba, dm, fill);
+        } else {
+            MultiFab mf(ba, dm, m_ncomp, 0);
+            fill(mf);
+            std::swap(mf, m_data[lev]);
+        }
+    }
+
+    void ClearLevel (int lev) override { m_data[lev].clear(); }
+
+private:
+    int  m_ncomp  = 4;
+    bool m_incremental = false;
+    Vector<MultiFab> m_data;
+
+    Real m_radius = Real(0.25);
+    Real m_width  = Real(0.02);
+    Real m_speed  = Real(0.1);
+};
+
+namespace {
+
+void check_grids (RegridBenchmark& amr, Real time, BoxArray const& fine_grids)
+{
+    if (!fine_grids.isDisjoint()) {
+        amrex::Abort("RegridBenchmark: fine grids are not disjoint");
+    }
+
+    TagBoxArray tags(amr.boxArray(0), amr.DistributionMap(0));
+    amr.ErrorEst(0, tags, time, 0);
+    Gpu::PinnedVector<IntVect> tagvec;
+    tags.local_collate(tagvec);
+
+    const BoxArray cba = amrex::coarsen(fine_grids, amr.refRatio(0));
+    Long nmissed = 0;
+    for (auto const& iv : tagvec) {
+        if (!cba.contains(iv)) { ++nmissed; }
+    }
+    ParallelDescriptor::ReduceLongSum(nmissed);
+    if (nmissed > 0) {
+        amrex::Abort("RegridBenchmark: "+std::to_string(nmissed)+" tags not covered by the fine grids");
+    }
+}
+
+// Cells of ba that are on a different process in old_ba
+Long remote_cells (BoxArray const& ba, DistributionMapping const& dm,
+                   BoxArray const& old_ba, DistributionMapping const& old_dm)
+{
+    Long n = 0;
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        old_ba.intersections(ba[i], isects);
+        for (auto const& is : isects) {
+            if (old_dm[is.first] != dm[i]) { n += is.second.numPts(); }
+        }
+    }
+    return n;
+}
+
+// Boxes of ba that are also in old_ba but on a different process
+int moved_boxes (BoxArray const& ba, DistributionMapping const& dm,
+                 BoxArray const& old_ba, DistributionMapping const& old_dm)
+{
+    int n = 0;
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        old_ba.intersections(ba[i], isects);
+        if (isects.size() == 1 && old_ba[isects[0].first] == ba[i]
+            && old_dm[isects[0].first] != dm[i]) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nsteps = 5;
+        Real dt = Real(0.1);
+        {
+            ParmParse pp("regrid");
+            pp.query("nsteps", nsteps);
+            pp.query("dt", dt);
+        }
+
+        RegridBenchmark amr;
+        AMREX_ALWAYS_ASSERT(amr.maxLevel() >= 1);
+        amr.InitFromScratch(0.0);
+
+        for (int distributed = 0; distributed <= 1; ++distributed)
+        {
+            amr.setDistributedClustering(distributed);
+
+            Real elapsed = 0.0;
+            Vector<BoxArray> new_grids;
+            Real time = 0.0;
+            for (int step = 0; step < nsteps; ++step)
+            {
+                time = step*dt;
+                int new_finest;
+                ParallelDescriptor::Barrier();
+                Real t0 = amrex::second();
+                amr.MakeNewGrids(0, time, new_finest, new_grids);
+                Real t1 = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t1);
+                elapsed += t1;
+            }
+
+            check_grids(amr, time, new_grids[1]);
+
+            TagBoxArray tags(amr.boxArray(0), amr.DistributionMap(0));
+            amr.ErrorEst(0, tags, time, 0);
+            Gpu::PinnedVector<IntVect> tagvec;
+            tags.local_collate(tagvec);
+            Long ntags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(ntags);
+            const Real ncells = amrex::coarsen(new_grids[1], amr.refRatio(0)).d_numPts();
+
+            amrex::Print() << (distributed ? "distributed" : "serial     ")
+                           << " clustering: " << elapsed/nsteps << " s per regrid, "
+                           << new_grids[1].size() << " fine grids, "
+                           << Real(ntags)/ncells << " of the cells tagged\n";
+        }
+
+        amr.setDistributedClustering(false);
+        Long nremote_full = 0;
+        for (int incremental = 0; incremental <= 1; ++incremental)
+        {
+            amr.setIncrementalRegrid(incremental);
+            amr.InitFromScratch(0.0);
+
+            Real elapsed = 0.0;
+            Long nremote = 0;
+            Long nkept = 0;
+            for (int step = 1; step <= nsteps; ++step)
+            {
+                const BoxArray old_ba = amr.boxArray(1);
+                const DistributionMapping old_dm = amr.DistributionMap(1);
+                Vector<const Real*> old_ptrs(old_ba.size(), nullptr);
+                for (MFIter mfi(amr.data(1)); mfi.isValid(); ++mfi) {
+                    old_ptrs[mfi.index()] = amr.data(1)[mfi].dataPtr();
+                }
+                ParallelDescriptor::Barrier();
+                Real t0 = amrex::second();
+                amr.regrid(0, step*dt);
+                Real t1 = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t1);
+                elapsed += t1;
+                nremote += remote_cells(amr.boxArray(1), amr.DistributionMap(1), old_ba, old_dm);
+                if (incremental) {
+                    AMREX_ALWAYS_ASSERT(moved_boxes(amr.boxArray(1), amr.DistributionMap(1),
+                                                    old_ba, old_dm) == 0);
+                    const Vector<int> old_index = amrex::SameBoxIndices(
+                        amr.boxArray(1), amr.DistributionMap(1), old_ba, old_dm);
+                    for (MFIter mfi(amr.data(1)); mfi.isValid(); ++mfi) {
+                        if (old_index[mfi.index()] >= 0) {
+                            AMREX_ALWAYS_ASSERT(amr.data(1)[mfi].dataPtr()
+                                                == old_ptrs[old_index[mfi.index()]]);
+                            ++nkept;
+                        }
+                    }
+                }
+                AMREX_ALWAYS_ASSERT(amr.data(1).min(0) == Real(1.0) &&
+                                    amr.data(1).max(0) == Real(1.0));
+            }
+            ParallelDescriptor::ReduceLongSum(nkept);
+
+            const BoxArray& ba = amr.boxArray(1);
+            Vector<Real> cost(ba.size());
+            for (int i = 0; i < ba.size(); ++i) { cost[i] = static_cast<Real>(ba[i].numPts()); }
+            Real eff;
+            DistributionMapping::ComputeDistributionMappingEfficiency(amr.DistributionMap(1), cost, &eff);
+
+            amrex::Print() << (incremental ? "incremental" : "full       ")
+                           << " regrid: " << elapsed/nsteps << " s per regrid, "
+                           << nremote/nsteps << " fine cells per regrid copied between processes, "
+                           << "load efficiency " << eff;
+            if (incremental) {
+                amrex::Print() << ", " << nkept/nsteps << " fine grids per regrid kept";
+            }
+            amrex::Print() << "\n";
+
+            if (incremental) {
+                AMREX_ALWAYS_ASSERT(nremote <= nremote_full);
+            } else {
+                nremote_full = nremote;
+            }
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,177 @@
+#include <AMReX.H>
+#include <AMReX_CArena.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+struct Block
+{
+    unsigned char* p = nullptr;
+    std::size_t nbytes = 0;
+    unsigned char tag = 0;
+};
+
+std::uint32_t next_random (std::uint32_t& state) noexcept
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+// Mostly small requests, a few above the size class limit.
+std::size_t random_size (std::uint32_t& state, std::size_t class_max) noexcept
+{
+    const std::uint32_t r = next_random(state);
+    if (r % 16 == 0) {
+        return class_max + r % (4*class_max);
+    } else if (r % 4 == 0) {
+        return 1 + r % class_max;
+    } else {
+        return 1 + r % 512;
+    }
+}
+
+void fill (Block& b, unsigned char tag) noexcept
+{
+    b.tag = tag;
+    for (std::size_t i = 0; i < b.nbytes; ++i) { b.p[i] = tag; }
+}
+
+bool intact (Block const& b) noexcept
+{
+    for (std::size_t i = 0; i < b.nbytes; ++i) {
+        if (b.p[i] != b.tag) { return false; }
+    }
+    return true;
+}
+
+}
+
+void main_main ()
+{
+    int nblocks = 4000;
+    int nrounds = 8;
+    {
+        ParmParse pp;
+        pp.query("nblocks", nblocks);
+        pp.query("nrounds", nrounds);
+    }
+
+    const std::size_t class_max = 64*1024;
+    const Long cache_size = 256*1024;
+
+    {
+        amrex::Print() << "OpenMP stress:" << std::endl;
+        CArena arena(0, ArenaInfo().SetSizeClasses(class_max, cache_size));
+        AMREX_ALWAYS_ASSERT(arena.sizeClassMax() >= class_max);
+
+        std::vector<Block> blocks(nblocks);
+        Long nsmall = 0;
+        int nbad = 0;
+
+        for (int round = 0; round < nrounds; ++round)
+        {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel reduction(+:nsmall,nbad)
+#endif
+            {
+                const int nthreads = OpenMP::get_num_threads();
+                const int tid = OpenMP::get_thread_num();
+                std::uint32_t state = 12345u + 7919u*(tid + round*64);
+
+                // Every thread allocates its share of the blocks ...
+                for (int i = tid; i < nblocks; i += nthreads) {
+                    Block& b = blocks[i];
+                    b.nbytes = random_size(state, class_max);
+                    b.p = static_cast<unsigned char*>(arena.alloc(b.nbytes));
+                    fill(b, static_cast<unsigned char>(i*31 + round));
+                    if (b.nbytes <= arena.sizeClassMax()) { ++nsmall; }
+                }
+#ifdef AMREX_USE_OMP
+#pragma omp barrier
+#endif
+                // ... and frees blocks handed out to the other threads, some of
+                // which are replaced right away.
+                for (int i = (tid+1)%nthreads; i < nblocks; i += nthreads) {
+                    Block& b = blocks[i];
+                    if (!intact(b)) { ++nbad; }
+                    arena.free(b.p);
+                    b.p = nullptr;
+                    if (i % 3 == 0) {
+                        b.nbytes = random_size(state, class_max);
+                        b.p = static_cast<unsigned char*>(arena.alloc(b.nbytes));
+                        fill(b, static_cast<unsigned char>(i*17 + round));
+                        if (b.nbytes <= arena.sizeClassMax()) { ++nsmall; }
+                    }
+                }
+#ifdef AMREX_USE_OMP
+#pragma omp barrier
+#endif
+                for (int i = tid; i < nblocks; i += nthreads) {
+                    Block& b = blocks[i];
+                    if (b.p) {
+                        if (!intact(b)) { ++nbad; }
+                        arena.free(b.p);
+                        b.p = nullptr;
+                    }
+                }
+            }
+
+            if (round == nrounds/2) {
+                arena.freeUnused();
+            }
+        }
+
+        auto stats = arena.sizeClassStats();
+        amrex::Print() << "  " << stats.nalloc << " size class allocations, "
+                       << stats.nhit << " cache hits, " << stats.nremote
+                       << " cross-thread frees, " << stats.nspill << " spills" << std::endl;
+        AMREX_ALWAYS_ASSERT(nbad == 0);
+        AMREX_ALWAYS_ASSERT(stats.nalloc == nsmall);
+        AMREX_ALWAYS_ASSERT(stats.nfree == nsmall);
+    }
+
+    {
+        amrex::Print() << "Thread exit:" << std::endl;
+        CArena arena(0, ArenaInfo().SetSizeClasses(class_max, cache_size));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&arena, t, nblocks, class_max] ()
+            {
+                std::uint32_t state = 777u + t;
+                std::vector<void*> ps;
+                for (int i = 0; i < nblocks; ++i) {
+                    ps.push_back(arena.alloc(1 + next_random(state) % class_max));
+                }
+                for (void* p : ps) { arena.free(p); }
+            });
+        }
+        for (auto& th : threads) { th.join(); }
+
+        auto stats = arena.sizeClassStats();
+        amrex::Print() << "  cached bytes after the threads exited: " << stats.cached_bytes << std::endl;
+        AMREX_ALWAYS_ASSERT(stats.cached_bytes == 0);
+
+        // Everything is back in the shared lists and can go to the system.
+        arena.freeUnused();
+        amrex::Print() << "  heap space used after freeUnused: " << arena.heap_space_used() << std::endl;
+        AMREX_ALWAYS_ASSERT(arena.heap_space_used() == 0);
+        AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+    }
+}
@@ -0,0 +1,224 @@
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_Machine.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <string>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+std::string name (DistributionMapping::Strategy how)
+{
+    switch (how) {
+    case DistributionMapping::ROUNDROBIN: return "ROUNDROBIN";
+    case DistributionMapping::KNAPSACK:   return "KNAPSACK";
+    case DistributionMapping::SFC:        return "SFC";
+    case DistributionMapping::RRSFC:      return "RRSFC";
+    case DistributionMapping::HILBERT:    return "HILBERT";
+    case DistributionMapping::GRAPH:      return "GRAPH";
+    default:                              return "UNDEFINED";
+    }
+}
+
+// The largest load of a process, checking that every box is on one of the nprocs.
+Long max_load (const BoxArray& ba, const DistributionMapping& dm, int nprocs)
+{
+    AMREX_ALWAYS_ASSERT(dm.size() == ba.size());
+    Vector<Long> load(nprocs, 0);
+    for (int i = 0; i < ba.size(); ++i) {
+        AMREX_ALWAYS_ASSERT(dm[i] >= 0 && dm[i] < nprocs);
+        load[dm[i]] += ba[i].numPts();
+    }
+    AMREX_ALWAYS_ASSERT(*std::min_element(load.begin(), load.end()) > 0);
+    return *std::max_element(load.begin(), load.end());
+}
+
+// Ghost cells, one cell wide, that boxes receive from other processes.
+Long edge_cut (const BoxArray& ba, const DistributionMapping& dm)
+{
+    Long cut = 0;
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0; i < ba.size(); ++i) {
+        ba.intersections(amrex::grow(ba[i],1), isects);
+        for (auto const& is : isects) {
+            if (dm[is.first] != dm[i]) { cut += is.second.numPts(); }
+        }
+    }
+    return cut;
+}
+
+}
+
+void main_main ()
+{
+    IntVect n_cell(AMREX_D_DECL(160,112,48));
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        Vector<int> nc;
+        if (pp.queryarr("n_cell", nc)) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) { n_cell[idim] = nc[idim]; }
+        }
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    // The strategy is selected in the inputs.
+    AMREX_ALWAYS_ASSERT(DistributionMapping::strategy() == DistributionMapping::HILBERT);
+
+    BoxArray ba(Box(IntVect(0), n_cell-1));
+    ba.maxSize(max_grid_size);
+    const Long totalvol = ba.numPts();
+
+    // An uneven BoxArray as well, with boxes of different sizes.
+    BoxArray ba2(Box(IntVect(0), n_cell-1));
+    ba2.maxSize(max_grid_size*2);
+    {
+        BoxList bl;
+        for (int i = 0; i < ba2.size(); ++i) {
+            if (i % 3 == 0) {
+                BoxArray tmp(ba2[i]);
+                tmp.maxSize(max_grid_size/2);
+                for (int j = 0; j < tmp.size(); ++j) { bl.push_back(tmp[j]); }
+            } else {
+                bl.push_back(ba2[i]);
+            }
+        }
+        ba2 = BoxArray(std::move(bl));
+    }
+
+    const auto saved = DistributionMapping::strategy();
+
+    for (const BoxArray* pba : {&ba, &ba2})
+    {
+        // Fewer processes than ranks would be mapped onto the least used
+        // ranks, so the maps are built for all of them.
+        {
+            const int nprocs = ParallelDescriptor::NProcs();
+            amrex::Print() << pba->size() << " boxes on " << nprocs << " processes:" << std::endl;
+
+            Long hilbert_load = 0, hilbert_cut = 0;
+            for (auto how : {DistributionMapping::SFC, DistributionMapping::HILBERT,
+                             DistributionMapping::GRAPH})
+            {
+                DistributionMapping::strategy(how);
+                DistributionMapping dm(*pba, nprocs);
+                const Long maxload = max_load(*pba, dm, nprocs);
+                const Long cut = edge_cut(*pba, dm);
+                const Real eff = Real(totalvol) / Real(nprocs*maxload);
+                amrex::Print() << "  " << name(how) << ":  efficiency " << eff
+                               << ", ghost cells from other processes " << cut << std::endl;
+
+                // Building the map again gives the same map.
+                AMREX_ALWAYS_ASSERT(DistributionMapping(*pba, nprocs) == dm);
+
+                if (how == DistributionMapping::HILBERT) {
+                    hilbert_load = maxload;
+                    hilbert_cut = cut;
+                    AMREX_ALWAYS_ASSERT(eff > Real(0.9));
+                } else if (how == DistributionMapping::GRAPH) {
+                    // GRAPH refines the Hilbert partition within 5% extra imbalance.
+                    AMREX_ALWAYS_ASSERT(Real(maxload) <= std::max(Real(hilbert_load),
+                                                                  Real(1.05)*Real(totalvol)/Real(nprocs)));
+                    AMREX_ALWAYS_ASSERT(cut <= hilbert_cut);
+                }
+                if (nprocs == 1) {
+                    AMREX_ALWAYS_ASSERT(cut == 0);
+                }
+            }
+        }
+    }
+
+    amrex::Print() << "Topology aware:" << std::endl;
+    DistributionMapping::TopologyAware(true);
+
+    // On a single node the two-level mapping falls back to the flat one.
+    bool one_node = true;
+#ifdef AMREX_USE_MPI
+    for (int id : machine::shared_memory_node_ids()) {
+        one_node = one_node && (id == 0);
+    }
+#endif
+    for (auto how : {DistributionMapping::SFC, DistributionMapping::KNAPSACK,
+                     DistributionMapping::HILBERT})
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+        DistributionMapping::strategy(how);
+        DistributionMapping::NodeSize(0);
+        DistributionMapping dm(ba2, nprocs);
+        max_load(ba2, dm, nprocs);
+        if (one_node) {
+            DistributionMapping::TopologyAware(false);
+            AMREX_ALWAYS_ASSERT(DistributionMapping(ba2, nprocs) == dm);
+            DistributionMapping::TopologyAware(true);
+        }
+
+        // Nodes of four processes, the last of which may be partly filled.
+        // Only the two-level path is taken for these, which does not need
+        // the processes to exist.
+        DistributionMapping::NodeSize(4);
+        for (int np : {8, 6}) {
+            DistributionMapping tdm(ba2, np);
+            const Long maxload = max_load(ba2, tdm, np);
+            AMREX_ALWAYS_ASSERT(DistributionMapping(ba2, np) == tdm);
+
+            Long maxbox = 0;
+            for (int i = 0; i < ba2.size(); ++i) {
+                maxbox = std::max(maxbox, ba2[i].numPts());
+            }
+            Vector<Long> nodeload(2, 0);
+            Long internode = 0;
+            std::vector<std::pair<int,Box> > isects;
+            for (int i = 0; i < ba2.size(); ++i) {
+                nodeload[tdm[i]/4] += ba2[i].numPts();
+                ba2.intersections(amrex::grow(ba2[i],1), isects);
+                for (auto const& is : isects) {
+                    if (tdm[is.first]/4 != tdm[i]/4) { internode += is.second.numPts(); }
+                }
+            }
+            // Each node gets its share of the boxes, give or take a box
+            // and the extra imbalance allowed to the refinement.
+            for (int n = 0; n < 2; ++n) {
+                const Real target = Real(totalvol) * Real(std::min(4, np-4*n)) / Real(np);
+                AMREX_ALWAYS_ASSERT(Real(nodeload[n]) <= Real(1.05)*target + Real(maxbox));
+            }
+            const Real eff = Real(totalvol) / Real(np*maxload);
+            amrex::Print() << "  " << name(how) << " on " << np << " processes:  efficiency "
+                           << eff << ", ghost cells between nodes " << internode
+                           << ", of " << edge_cut(ba2, tdm) << " between processes" << std::endl;
+            AMREX_ALWAYS_ASSERT(eff > Real(0.7));
+            AMREX_ALWAYS_ASSERT(internode <= edge_cut(ba2, tdm));
+        }
+    }
+
+    DistributionMapping::TopologyAware(false);
+    DistributionMapping::NodeSize(0);
+    DistributionMapping::strategy(saved);
+
+    // The report covers every strategy it builds.
+    auto report = DistributionMapping::CommReport(ba, IntVect(1), true);
+    AMREX_ALWAYS_ASSERT(report.size() == 4);
+    for (auto const& r : report) {
+        AMREX_ALWAYS_ASSERT(r.second.efficiency > Real(0.) && r.second.efficiency <= Real(1.));
+        if (ParallelDescriptor::NProcs() == 1) {
+            AMREX_ALWAYS_ASSERT(r.second.total == 0);
+        }
+        if (r.first == DistributionMapping::GRAPH) {
+            AMREX_ALWAYS_ASSERT(r.second.total <= report[2].second.total);
+        }
+    }
+}
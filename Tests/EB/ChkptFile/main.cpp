@@ -0,0 +1,136 @@
+/*
+ * Writes an EB2::IndexSpace with two levels to a checkpoint and reads it
+ * back with EB2::BuildFromChkptFile.  The cell flags, volume fractions,
+ * area fractions and the other EB data read must be bitwise identical to
+ * those built.
+ */
+
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <cstring>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// The number of values that differ, including the ghost cells.
+Long ndiff (MultiFab const& a, MultiFab const& b)
+{
+    Long n = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), a.nComp(), [&] (int i, int j, int k, int c) noexcept
+        {
+            if (std::memcmp(&x(i,j,k,c), &y(i,j,k,c), sizeof(Real)) != 0) { ++n; }
+        });
+    }
+    return n;
+}
+
+Long ndiff (MultiCutFab const& a, MultiCutFab const& b)
+{
+    Long n = 0;
+    for (MFIter mfi(a.boxArray(), a.DistributionMap()); mfi.isValid(); ++mfi) {
+        if (a.ok(mfi) != b.ok(mfi)) {
+            ++n;
+        } else if (a.ok(mfi)) {
+            auto const& x = a.const_array(mfi);
+            auto const& y = b.const_array(mfi);
+            amrex::LoopOnCpu(amrex::grow(mfi.validbox(),a.nGrow()), a.nComp(),
+            [&] (int i, int j, int k, int c) noexcept
+            {
+                if (std::memcmp(&x(i,j,k,c), &y(i,j,k,c), sizeof(Real)) != 0) { ++n; }
+            });
+        }
+    }
+    return n;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    std::string chkpt_file = "eb_chkpt";
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("chkpt_file", chkpt_file);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Geometry geom(domain, rb, 0, is_periodic);
+
+    // Off the cell centers, so that the cut cells are not all alike
+    EB2::SphereIF sphere(0.31, {AMREX_D_DECL(0.47,0.5,0.52)}, false);
+    EB2::Build(EB2::makeShop(sphere), geom, 0, 1);
+    const EB2::IndexSpace* built = &EB2::IndexSpace::top();
+
+    built->writeToChkptFile(chkpt_file);
+    EB2::BuildFromChkptFile(chkpt_file, geom);
+    const EB2::IndexSpace* read = &EB2::IndexSpace::top();
+    AMREX_ALWAYS_ASSERT(read != built);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    for (int ilev = 0; ilev < 2; ++ilev)
+    {
+        const Geometry g = (ilev == 0) ? geom : amrex::coarsen(geom,2);
+        const BoxArray cba = amrex::coarsen(ba, 1<<ilev);
+        auto bfact = makeEBFabFactory(built, g, cba, dm, {2,2,2}, EBSupport::full);
+        auto rfact = makeEBFabFactory(read, g, cba, dm, {2,2,2}, EBSupport::full);
+
+        Long nflag = 0, ncut = 0;
+        auto const& bflags = bfact->getMultiEBCellFlagFab();
+        auto const& rflags = rfact->getMultiEBCellFlagFab();
+        for (MFIter mfi(bflags); mfi.isValid(); ++mfi) {
+            auto const& x = bflags.const_array(mfi);
+            auto const& y = rflags.const_array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+            {
+                if (x(i,j,k).getValue() != y(i,j,k).getValue()) { ++nflag; }
+                if (x(i,j,k).isSingleValued()) { ++ncut; }
+            });
+        }
+
+        Long nvolfrac = ndiff(bfact->getVolFrac(), rfact->getVolFrac());
+        Long narea = 0;
+        Long nother = ndiff(bfact->getCentroid(), rfact->getCentroid())
+            + ndiff(bfact->getBndryArea(), rfact->getBndryArea())
+            + ndiff(bfact->getBndryCent(), rfact->getBndryCent())
+            + ndiff(bfact->getBndryNormal(), rfact->getBndryNormal());
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            narea += ndiff(*bfact->getAreaFrac()[idim], *rfact->getAreaFrac()[idim]);
+            nother += ndiff(*bfact->getFaceCent()[idim], *rfact->getFaceCent()[idim]);
+        }
+
+        ParallelDescriptor::ReduceLongSum({nflag, ncut, nvolfrac, narea, nother});
+        amrex::Print() << "Level " << ilev << ": " << ncut << " cut cells, differences in"
+                       << " cell flags " << nflag << ", volume fractions " << nvolfrac
+                       << ", area fractions " << narea << ", other data " << nother
+                       << std::endl;
+        AMREX_ALWAYS_ASSERT(ncut > 0);
+        AMREX_ALWAYS_ASSERT(nflag == 0 && nvolfrac == 0 && narea == 0 && nother == 0);
+    }
+}
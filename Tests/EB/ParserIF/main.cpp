@@ -0,0 +1,157 @@
+/*
+ * Tests the Newton root finder GeometryShop uses for implicit functions
+ * with derivatives.  On cell edges crossing the surface, it must find the
+ * roots Brent's method finds, also where the derivative vanishes at the
+ * root or is not finite and Newton's method has to fall back to bisection.  Then the EB
+ * built with eb2.geom_type = parser, which uses the derivatives of the
+ * parser function, is compared with the one built without them.
+ */
+
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Parser.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+struct ParserWithDerivatives
+{
+    explicit ParserWithDerivatives (std::string const& f)
+        : parser(f)
+    {
+        parser.registerVariables({"x","y","z"});
+        for (int idim = 0; idim < 3; ++idim) {
+            dparser[idim] = parser.derivative(std::string(1,char('x'+idim)));
+            dexe[idim] = dparser[idim].compile<3>();
+        }
+    }
+    Parser parser;
+    Array<Parser,3> dparser;
+    GpuArray<ParserExecutor<3>,3> dexe;
+};
+
+// Returns the number of edges crossing the surface, checking the roots
+// found by Newton's method against those found by Brent's method.
+int test_root_finder (std::string const& f, Real h, int nsegments)
+{
+    amrex::Print() << "Roots of \"" << f << "\": ";
+    ParserWithDerivatives pwd(f);
+    EB2::ParserIF newton_if(pwd.parser.compile<3>(), pwd.dexe);
+    EB2::ParserIF brent_if(pwd.parser.compile<3>());
+    AMREX_ALWAYS_ASSERT(newton_if.hasDerivative() && !brent_if.hasDerivative());
+
+    std::uint32_t state = 1234u;
+    auto uniform = [&state] () {
+        state = state * 1664525u + 1013904223u;
+        return Real(state >> 8) / Real(1u << 24);
+    };
+
+    int ncross = 0;
+    Real maxdiff = 0;
+    for (int n = 0; n < nsegments; ++n) {
+        const int dir = n % 3;
+        GpuArray<Real,3> lo{uniform(), uniform(), uniform()};
+        GpuArray<Real,3> hi = lo;
+        hi[dir] += h;
+        if (EB2::IF_f(brent_if, lo) * EB2::IF_f(brent_if, hi) > 0.0) { continue; }
+        ++ncross;
+        const Real xn = EB2::IF_RootFinder(lo, hi, dir, newton_if);
+        const Real xb = EB2::IF_RootFinder(lo, hi, dir, brent_if);
+        AMREX_ALWAYS_ASSERT(xn >= std::min(lo[dir],hi[dir]) && xn <= std::max(lo[dir],hi[dir]));
+        maxdiff = std::max(maxdiff, std::abs(xn-xb));
+    }
+    amrex::Print() << ncross << " edges cross the surface, max difference to Brent "
+                   << maxdiff << std::endl;
+    AMREX_ALWAYS_ASSERT(maxdiff < Real(1.e-10));
+    return ncross;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    int nsegments = 2000;
+    std::string fn_string;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nsegments", nsegments);
+        ParmParse ppeb2("eb2");
+        ppeb2.get("parser_function", fn_string);
+    }
+    const Real h = Real(1.0)/n_cell;
+
+    AMREX_ALWAYS_ASSERT(test_root_finder(fn_string, h, nsegments*10) > 0);
+    // The derivative in x vanishes at the root where y = 0.5, so Newton's
+    // method converges slowly or not at all there without bisection.
+    AMREX_ALWAYS_ASSERT(test_root_finder("(x-0.41)^3 + 0.001*(y-0.5)", Real(0.25), nsegments) > 0);
+    AMREX_ALWAYS_ASSERT(test_root_finder("atan(20*(x-0.5)) + 0.3*(z-0.5)", Real(0.25), nsegments) > 0);
+    // The derivative of sqrt(x-x) is 0/0, so that the derivative in x is
+    // NaN everywhere, and that of the signed square root is infinite at the
+    // root.  Both must be left to bisection.
+    AMREX_ALWAYS_ASSERT(test_root_finder("x - 0.41 + 0.2*(y-0.5) + sqrt(x-x)", Real(0.25), nsegments) > 0);
+    AMREX_ALWAYS_ASSERT(test_root_finder("if(x<0.41, -sqrt(0.41-x), sqrt(x-0.41)) + 0.01*(y-0.5)",
+                                         Real(0.25), nsegments) > 0);
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({0.,0.,0.}, {1.,1.,1.});
+    Geometry geom(domain, rb, 0, {0,0,0});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // eb2.geom_type = parser in the inputs, with the derivatives by default
+    EB2::Build(geom, 0, 0);
+    auto newton_fact = makeEBFabFactory(&EB2::IndexSpace::top(), geom, ba, dm,
+                                        {1,1,1}, EBSupport::full);
+
+    Parser parser(fn_string);
+    parser.registerVariables({"x","y","z"});
+    EB2::ParserIF pif(parser.compile<3>());
+    EB2::Build(EB2::makeShop(pif, parser), geom, 0, 0);
+    auto brent_fact = makeEBFabFactory(&EB2::IndexSpace::top(), geom, ba, dm,
+                                       {1,1,1}, EBSupport::full);
+
+    MultiFab diff(ba, dm, 1, 0);
+    MultiFab::Copy(diff, newton_fact->getVolFrac(), 0, 0, 1, 0);
+    MultiFab::Subtract(diff, brent_fact->getVolFrac(), 0, 0, 1, 0);
+    Real maxdiff = diff.norm0();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        auto const& na = *newton_fact->getAreaFrac()[idim];
+        auto const& ba2 = *brent_fact->getAreaFrac()[idim];
+        for (MFIter mfi(ba, dm); mfi.isValid(); ++mfi) {
+            AMREX_ALWAYS_ASSERT(na.ok(mfi) == ba2.ok(mfi));
+            if (!na.ok(mfi)) { continue; }
+            auto const& x = na.const_array(mfi);
+            auto const& y = ba2.const_array(mfi);
+            const Box& fbx = amrex::surroundingNodes(mfi.validbox(), idim);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k) noexcept
+            {
+                maxdiff = std::max(maxdiff, std::abs(x(i,j,k)-y(i,j,k)));
+            });
+        }
+    }
+    ParallelDescriptor::ReduceRealMax(maxdiff);
+    amrex::Print() << "EB from eb2.geom_type = parser: max difference in volume and area"
+                   << " fractions to Brent's method " << maxdiff << std::endl;
+    AMREX_ALWAYS_ASSERT(maxdiff < Real(1.e-9));
+}
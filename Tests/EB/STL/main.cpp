@@ -0,0 +1,271 @@
+/*
+ * Reads a binary STL fixture and checks the queries through the bounding
+ * volume hierarchy against brute force loops over all triangles and
+ * against the sphere the triangles approximate.  The same triangles are
+ * then written and read back as ASCII STL.  Finally, the EB built from
+ * the STL file with EB2::STLIF is compared with the one built from
+ * EB2::SphereIF.
+ */
+
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EB_STL_utils.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+struct HostSTL
+{
+    Vector<Real> tri;
+    Vector<STLBVHNode> nodes;
+    Real po[3];
+};
+
+HostSTL copy_to_host (STLtools const& stl)
+{
+    HostSTL h;
+    h.tri.resize(stl.num_triangles()*9);
+    Gpu::copy(Gpu::deviceToHost, stl.triangle_data(), stl.triangle_data()+h.tri.size(),
+              h.tri.begin());
+    h.nodes.resize(stl.num_bvh_nodes());
+    Gpu::copy(Gpu::deviceToHost, stl.bvh_data(), stl.bvh_data()+h.nodes.size(),
+              h.nodes.begin());
+    stl.get_point_outside(h.po);
+    return h;
+}
+
+Real brute_distance2 (HostSTL const& h, Real P[3])
+{
+    Real best = std::numeric_limits<Real>::max();
+    Real t1[3], t2[3], t3[3];
+    for (int tr = 0; tr < h.tri.size()/9; ++tr) {
+        stl_bvh::get_tri(h.tri.data(), tr, t1, t2, t3);
+        best = std::min(best, tri_geom_ops::point_tri_distance2(P, t1, t2, t3));
+    }
+    return best;
+}
+
+int brute_intersects (HostSTL const& h, Real p0[3], Real p1[3])
+{
+    int num = 0;
+    Real t1[3], t2[3], t3[3];
+    for (int tr = 0; tr < h.tri.size()/9; ++tr) {
+        stl_bvh::get_tri(h.tri.data(), tr, t1, t2, t3);
+        num += (1-tri_geom_ops::lineseg_tri_intersect(p0, p1, t1, t2, t3));
+    }
+    return num;
+}
+
+}
+
+void main_main ()
+{
+    std::string stl_file = "sphere.stl";
+    Real radius = 0.3;
+    Vector<Real> center{0.5, 0.5, 0.5};
+    int n_cell = 32;
+    int npoints = 2000;
+    {
+        ParmParse pp;
+        pp.query("stl_file", stl_file);
+        pp.query("radius", radius);
+        pp.queryarr("center", center);
+        pp.query("n_cell", n_cell);
+        pp.query("npoints", npoints);
+    }
+
+    STLtools stl;
+    stl.read_stl_file(stl_file);
+    AMREX_ALWAYS_ASSERT(stl.num_triangles() == 320);
+    HostSTL h = copy_to_host(stl);
+
+    // The facets are inside the sphere, by at most their sagitta.
+    const Real tol = Real(0.01);
+
+    amrex::Print() << "BVH queries at " << npoints << " points:" << std::endl;
+    Vector<std::array<Real,3> > points;
+    {
+        std::uint32_t state = 2021u;
+        auto uniform = [&state] () {
+            state = state * 1664525u + 1013904223u;
+            return Real(state >> 8) / Real(1u << 24);
+        };
+        for (int n = 0; n < npoints; ++n) {
+            points.push_back({uniform(), uniform(), uniform()});
+        }
+    }
+
+    Vector<Real> dist(npoints);
+    Real maxerr = 0;
+    for (int n = 0; n < npoints; ++n)
+    {
+        Real P[3] = {points[n][0], points[n][1], points[n][2]};
+        Real po[3] = {h.po[0], h.po[1], h.po[2]};
+
+        const Real d2 = stl_bvh::distance2(h.nodes.data(), h.tri.data(), P);
+        AMREX_ALWAYS_ASSERT(d2 == brute_distance2(h, P));
+
+        const int nx = stl_bvh::num_intersects(h.nodes.data(), h.tri.data(), po, P);
+        AMREX_ALWAYS_ASSERT(nx == brute_intersects(h, po, P));
+
+        dist[n] = stl_bvh::signed_distance(h.nodes.data(), h.tri.data(), P, po);
+        AMREX_ALWAYS_ASSERT(std::abs(dist[n]) == std::sqrt(d2));
+
+        Real r = 0;
+        for (int d = 0; d < 3; ++d) { r += (P[d]-center[d])*(P[d]-center[d]); }
+        r = std::sqrt(r) - radius;
+        if (std::abs(r) > tol) {
+            AMREX_ALWAYS_ASSERT((r < 0) == (dist[n] < 0));
+        }
+        maxerr = std::max(maxerr, std::abs(dist[n]-r));
+    }
+    amrex::Print() << "  distances match brute force, max difference to the sphere "
+                   << maxerr << std::endl;
+    AMREX_ALWAYS_ASSERT(maxerr < tol);
+
+    amrex::Print() << "Marker and distance fabs:" << std::endl;
+    {
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({0.,0.,0.}, {1.,1.,1.});
+        Geometry geom(domain, rb, 0, {0,0,0});
+        BoxArray ba(domain);
+        ba.maxSize(n_cell/2);
+        DistributionMapping dm(ba);
+        MultiFab marker(ba, dm, 1, 0);
+        MultiFab sdist(ba, dm, 1, 0);
+        stl.stl_to_markerfab(marker, geom, h.po);
+        stl.stl_to_signed_distance(sdist, geom, h.po);
+
+        const auto dx = geom.CellSizeArray();
+        int nbad = 0;
+        for (MFIter mfi(marker); mfi.isValid(); ++mfi) {
+            auto const& m = marker.const_array(mfi);
+            auto const& s = sdist.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+            {
+                Real P[3] = {i*dx[0], j*dx[1], k*dx[2]};
+                Real po[3] = {h.po[0], h.po[1], h.po[2]};
+                const bool inside = brute_intersects(h, po, P) % 2 == 1;
+                const Real d = std::sqrt(brute_distance2(h, P));
+                if ((m(i,j,k) < 0) != inside || s(i,j,k) != (inside ? -d : d)) { ++nbad; }
+            });
+        }
+        ParallelDescriptor::ReduceIntSum(nbad);
+        AMREX_ALWAYS_ASSERT(nbad == 0);
+        amrex::Print() << "  match brute force" << std::endl;
+    }
+
+    amrex::Print() << "ASCII STL:" << std::endl;
+    {
+        const std::string ascii_file = "sphere_ascii.stl";
+        if (ParallelDescriptor::IOProcessor()) {
+            std::ofstream ofs(ascii_file);
+            ofs << std::setprecision(std::numeric_limits<Real>::max_digits10);
+            ofs << "solid sphere\n";
+            for (int tr = 0; tr < stl.num_triangles(); ++tr) {
+                ofs << "facet normal 0 0 0\nouter loop\n";
+                for (int v = 0; v < 3; ++v) {
+                    ofs << "vertex " << h.tri[tr*9+v*3] << " " << h.tri[tr*9+v*3+1]
+                        << " " << h.tri[tr*9+v*3+2] << "\n";
+                }
+                ofs << "endloop\nendfacet\n";
+            }
+            ofs << "endsolid sphere\n";
+        }
+        ParallelDescriptor::Barrier();
+
+        STLtools ascii;
+        ascii.read_stl_file(ascii_file);
+        AMREX_ALWAYS_ASSERT(ascii.num_triangles() == stl.num_triangles());
+        HostSTL ha = copy_to_host(ascii);
+        for (int n = 0; n < npoints; ++n) {
+            Real P[3] = {points[n][0], points[n][1], points[n][2]};
+            Real po[3] = {h.po[0], h.po[1], h.po[2]};
+            AMREX_ALWAYS_ASSERT(stl_bvh::signed_distance(ha.nodes.data(), ha.tri.data(), P, po)
+                                == dist[n]);
+        }
+        amrex::Print() << "  same distances as the binary file" << std::endl;
+    }
+
+    amrex::Print() << "EB2::STLIF:" << std::endl;
+    {
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({0.,0.,0.}, {1.,1.,1.});
+        Geometry geom(domain, rb, 0, {0,0,0});
+        BoxArray ba(domain);
+        ba.maxSize(n_cell/2);
+        DistributionMapping dm(ba);
+
+        EB2::SphereIF sphere(radius, {center[0], center[1], center[2]}, false);
+        EB2::Build(EB2::makeShop(sphere), geom, 0, 0);
+        auto sphere_fact = makeEBFabFactory(&EB2::IndexSpace::top(), geom, ba, dm,
+                                            {1,1,1}, EBSupport::full);
+
+        // eb2.geom_type = stl in the inputs
+        EB2::Build(geom, 0, 0);
+        auto stl_fact = makeEBFabFactory(&EB2::IndexSpace::top(), geom, ba, dm,
+                                         {1,1,1}, EBSupport::full);
+
+        // Volume enclosed by the triangles
+        Real polyvol = 0;
+        for (int tr = 0; tr < stl.num_triangles(); ++tr) {
+            Real const* t = h.tri.data() + tr*9;
+            polyvol += (t[0]*(t[4]*t[8]-t[5]*t[7]) - t[1]*(t[3]*t[8]-t[5]*t[6])
+                        + t[2]*(t[3]*t[7]-t[4]*t[6])) / Real(6.0);
+        }
+        polyvol = std::abs(polyvol);
+        const Real spherevol = Real(4.0)/Real(3.0)*Real(3.1415926535897932)*radius*radius*radius;
+        const Real cellvol = geom.CellSize(0)*geom.CellSize(1)*geom.CellSize(2);
+        const Real stl_body = Real(1.0) - stl_fact->getVolFrac().sum()*cellvol;
+        const Real sphere_body = Real(1.0) - sphere_fact->getVolFrac().sum()*cellvol;
+        amrex::Print() << "  body volume " << stl_body << " (polyhedron " << polyvol
+                       << "), SphereIF " << sphere_body << " (sphere " << spherevol << ")"
+                       << std::endl;
+        AMREX_ALWAYS_ASSERT(std::abs(stl_body-polyvol) < Real(1.e-2)*polyvol);
+        AMREX_ALWAYS_ASSERT(std::abs(sphere_body-spherevol) < Real(1.e-2)*spherevol);
+        // The discretization errors of the two are nearly the same, so the
+        // difference between them is that between the polyhedron and the sphere.
+        AMREX_ALWAYS_ASSERT(std::abs((stl_body-sphere_body)-(polyvol-spherevol))
+                            < Real(0.1)*(spherevol-polyvol));
+
+        // Cells differ by no more than the gap between the facets and the
+        // sphere, which is a fraction of a cell.
+        int nbad = 0;
+        Real maxdiff = 0;
+        for (MFIter mfi(ba,dm); mfi.isValid(); ++mfi) {
+            auto const& sflag = sphere_fact->getMultiEBCellFlagFab().const_array(mfi);
+            auto const& tflag = stl_fact->getMultiEBCellFlagFab().const_array(mfi);
+            auto const& svf = sphere_fact->getVolFrac().const_array(mfi);
+            auto const& tvf = stl_fact->getVolFrac().const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+            {
+                if ((sflag(i,j,k).isRegular() && tflag(i,j,k).isCovered()) ||
+                    (sflag(i,j,k).isCovered() && tflag(i,j,k).isRegular())) { ++nbad; }
+                maxdiff = std::max(maxdiff, std::abs(svf(i,j,k)-tvf(i,j,k)));
+            });
+        }
+        ParallelDescriptor::ReduceIntSum(nbad);
+        ParallelDescriptor::ReduceRealMax(maxdiff);
+        amrex::Print() << "  max volume fraction difference to SphereIF " << maxdiff << std::endl;
+        AMREX_ALWAYS_ASSERT(nbad == 0 && maxdiff < Real(0.25));
+    }
+}
@@ -0,0 +1,116 @@
+#include <AMReX.H>
+#include <AMReX_FabConv.H>
+#include <AMReX_FPC.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Time nrep calls of f, returning the seconds per call.
+template <typename F>
+double timeit (int nrep, F&& f)
+{
+    f();  // warm up
+    double t0 = amrex::second();
+    for (int i = 0; i < nrep; ++i) {
+        f();
+    }
+    return (amrex::second() - t0) / nrep;
+}
+
+void bench (std::string const& name, RealDescriptor const& rd,
+            Vector<Real> const& src, int nrep)
+{
+    const Long n = src.size();
+    const Long nbytes = n * rd.numBytes();
+    // ---- narrowing to 32 bits may round differently than the generic path
+    const Real tol = (rd.numBytes() < int(sizeof(Real)) || sizeof(Real) < 8)
+        ? Real(2.0) * std::numeric_limits<float>::epsilon() : Real(0.0);
+
+    Vector<char> buf_generic(nbytes), buf_fast(nbytes);
+    Vector<Real> dst_generic(n), dst_fast(n);
+
+    RealDescriptor::SetUseFastConversions(false);
+    double t_from_generic = timeit(nrep, [&] () {
+        RealDescriptor::convertFromNativeFormat(buf_generic.data(), n, src.data(), rd);
+    });
+    double t_to_generic = timeit(nrep, [&] () {
+        RealDescriptor::convertToNativeFormat(dst_generic.data(), n, buf_generic.data(), rd);
+    });
+
+    RealDescriptor::SetUseFastConversions(true);
+    double t_from_fast = timeit(nrep, [&] () {
+        RealDescriptor::convertFromNativeFormat(buf_fast.data(), n, src.data(), rd);
+    });
+    double t_to_fast = timeit(nrep, [&] () {
+        RealDescriptor::convertToNativeFormat(dst_fast.data(), n, buf_generic.data(), rd);
+    });
+
+    // ---- both paths must read back the same values
+    Vector<Real> back(n);
+    RealDescriptor::SetUseFastConversions(false);
+    RealDescriptor::convertToNativeFormat(back.data(), n, buf_fast.data(), rd);
+    RealDescriptor::SetUseFastConversions(true);
+    for (Long i = 0; i < n; ++i) {
+        AMREX_ALWAYS_ASSERT(std::abs(back[i] - dst_generic[i]) <= tol * std::abs(src[i]));
+        AMREX_ALWAYS_ASSERT(std::abs(dst_fast[i] - dst_generic[i]) <= tol * std::abs(src[i]));
+    }
+
+    const double mb = double(n) * sizeof(Real) / (1024.*1024.);
+    amrex::Print() << "  " << name << ":\n"
+                   << "    from native:  generic " << mb/t_from_generic << " MB/s,  fast "
+                   << mb/t_from_fast << " MB/s,  speedup " << t_from_generic/t_from_fast << "\n"
+                   << "    to native:    generic " << mb/t_to_generic << " MB/s,  fast "
+                   << mb/t_to_fast << " MB/s,  speedup " << t_to_generic/t_to_fast << "\n";
+}
+
+}
+
+void main_main ()
+{
+    Long nitems = 4*1024*1024;
+    int nrep = 4;
+    {
+        ParmParse pp;
+        pp.query("nitems", nitems);
+        pp.query("nrep", nrep);
+    }
+
+    Vector<Real> src(nitems);
+    for (auto& x : src) {
+        x = (amrex::Random() - Real(0.5)) * Real(1.e6);
+    }
+
+    amrex::Print() << "RealDescriptor conversion of " << nitems << " Reals\n";
+
+    if (FPC::NativeRealDescriptor() != FPC::Ieee64NormalRealDescriptor()) {
+        bench("IEEE 64 big endian", FPC::Ieee64NormalRealDescriptor(), src, nrep);
+    }
+    if (FPC::NativeRealDescriptor() != FPC::Ieee32NormalRealDescriptor()) {
+        bench("IEEE 32 big endian", FPC::Ieee32NormalRealDescriptor(), src, nrep);
+    }
+    if (FPC::NativeRealDescriptor() != FPC::Native32RealDescriptor()) {
+        bench("native 32", FPC::Native32RealDescriptor(), src, nrep);
+    }
+    if (FPC::NativeRealDescriptor() != FPC::Native64RealDescriptor()) {
+        bench("native 64", FPC::Native64RealDescriptor(), src, nrep);
+    }
+}
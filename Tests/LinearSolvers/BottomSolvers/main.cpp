@@ -0,0 +1,248 @@
+/*
+ * Solves cell-centered and nodal Poisson problems with MLMG, using the
+ * pipelined CG and BiCGStab bottom solvers as well as the classic ones.
+ * The pipelined solvers must converge in about as many MLMG iterations,
+ * to the same solution.  The fused dot products and norm they use,
+ * MLLinOp::xdotyNormInf, are checked against xdoty and norm0.
+ */
+
+#include <AMReX.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLNodeLaplacian.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+std::string name (BottomSolver s)
+{
+    switch (s) {
+    case BottomSolver::cg:           return "cg";
+    case BottomSolver::bicgstab:     return "bicgstab";
+    case BottomSolver::pipecg:       return "pipecg";
+    case BottomSolver::pipebicgstab: return "pipebicgstab";
+    default:                         return "other";
+    }
+}
+
+void init_rhs (MultiFab& rhs, Geometry const& geom)
+{
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const IntVect nodal = rhs.ixType().toIntVect();
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        auto const& a = rhs.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real r = 1.0;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real x = plo[idim] + (iv[idim] + 0.5*(1-nodal[idim]))*dx[idim];
+                r *= std::sin(3.0*x) + x*x;
+            }
+            a(i,j,k) = r;
+        });
+    }
+}
+
+std::unique_ptr<MLLinOp> make_linop (bool nodal, Geometry const& geom, BoxArray const& ba,
+                                     DistributionMapping const& dm, int max_coarsening_level)
+{
+    LPInfo info;
+    info.setMaxCoarseningLevel(max_coarsening_level);
+
+    std::unique_ptr<MLLinOp> linop;
+    if (nodal) {
+        auto p = std::make_unique<MLNodeLaplacian>(Vector<Geometry>{geom}, Vector<BoxArray>{ba},
+                                                   Vector<DistributionMapping>{dm}, info);
+        p->setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+        MultiFab sigma(ba, dm, 1, 1);
+        sigma.setVal(1.0);
+        p->setSigma(0, sigma);
+        linop = std::move(p);
+    } else {
+        auto p = std::make_unique<MLPoisson>(Vector<Geometry>{geom}, Vector<BoxArray>{ba},
+                                             Vector<DistributionMapping>{dm}, info);
+        p->setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+        p->setLevelBC(0, nullptr);
+        linop = std::move(p);
+    }
+    return linop;
+}
+
+// Fills mf with values that differ between the given seeds.
+void init_data (MultiFab& mf, int seed)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            a(i,j,k) = std::sin(Real(0.37)*(i+seed) + Real(0.11)*j*(seed+1) - Real(0.23)*k) + Real(0.1)*seed;
+        });
+    }
+}
+
+// The fused dot products and norm must match the separately computed ones,
+// with and without the norm.  Without coarsening, the nodal dot mask of
+// the bottom level applies to level 0.
+void check_xdoty_norm_inf (bool nodal, Geometry const& geom, BoxArray const& ba,
+                           DistributionMapping const& dm)
+{
+    auto linop = make_linop(nodal, geom, ba, dm, 0);
+    linop->prepareForSolve();
+
+    const BoxArray& nba = nodal ? amrex::convert(ba, IntVect(1)) : ba;
+    constexpr int ndata = 2*MLLinOp::max_fused_dots + 1;
+    Vector<MultiFab> data(ndata);
+    for (int i = 0; i < ndata; ++i) {
+        data[i].define(nba, dm, 1, 0);
+        init_data(data[i], i);
+    }
+    const MultiFab* x[MLLinOp::max_fused_dots];
+    const MultiFab* y[MLLinOp::max_fused_dots];
+    for (int id = 0; id < MLLinOp::max_fused_dots; ++id) {
+        x[id] = &data[2*id];
+        y[id] = &data[2*id+1];
+    }
+    const MultiFab& r = data[ndata-1];
+    const Real rnorm = r.norm0();
+
+    // The fused version of the linop and the default of MLLinOp
+    for (bool fused : {true, false}) {
+    for (int ndots = 0; ndots <= MLLinOp::max_fused_dots; ++ndots) {
+        for (bool with_norm : {true, false}) {
+            if (ndots == 0 && !with_norm) { continue; }
+            Real result[MLLinOp::max_fused_dots+1];
+            if (fused) {
+                linop->xdotyNormInf(0, 0, ndots, x, y, with_norm ? &r : nullptr, result);
+            } else {
+                linop->MLLinOp::xdotyNormInf(0, 0, ndots, x, y, with_norm ? &r : nullptr, result);
+            }
+            ParallelAllReduce::Sum(result, ndots, ParallelContext::CommunicatorSub());
+            for (int id = 0; id < ndots; ++id) {
+                const Real expected = linop->xdoty(0, 0, *x[id], *y[id], false);
+                AMREX_ALWAYS_ASSERT(std::abs(result[id] - expected)
+                                    <= Real(1.e-10)*std::max(Real(1.0), std::abs(expected)));
+            }
+            if (with_norm) {
+                ParallelAllReduce::Max(result[ndots], ParallelContext::CommunicatorSub());
+                AMREX_ALWAYS_ASSERT(result[ndots] == rnorm);
+            }
+        }
+    }
+    }
+}
+
+struct Result
+{
+    int niters;
+    int nbottom;
+    MultiFab phi;
+};
+
+Result solve (bool nodal, BottomSolver bottom, Geometry const& geom, BoxArray const& ba,
+              DistributionMapping const& dm, int max_coarsening_level, Real reltol,
+              int verbose, int bottom_verbose)
+{
+    const BoxArray& nba = nodal ? amrex::convert(ba, IntVect(1)) : ba;
+    MultiFab rhs(nba, dm, 1, 0);
+    Result result{0, 0, MultiFab(nba, dm, 1, 1)};
+    init_rhs(rhs, geom);
+    result.phi.setVal(0.0);
+
+    auto linop = make_linop(nodal, geom, ba, dm, max_coarsening_level);
+
+    MLMG mlmg(*linop);
+    mlmg.setVerbose(verbose);
+    mlmg.setBottomVerbose(bottom_verbose);
+    mlmg.setBottomSolver(bottom);
+    mlmg.solve({&result.phi}, {&rhs}, reltol, 0.0);
+
+    result.niters = mlmg.getNumIters();
+    for (int n : mlmg.getNumCGIters()) { result.nbottom += n; }
+    return result;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int max_coarsening_level = 2;
+    Real reltol = 1.e-10;
+    int verbose = 1;
+    int bottom_verbose = 0;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("max_coarsening_level", max_coarsening_level);
+        pp.query("reltol", reltol);
+        pp.query("verbose", verbose);
+        pp.query("bottom_verbose", bottom_verbose);
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Geometry geom(domain, rb, 0, is_periodic);
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    for (bool nodal : {false, true})
+    {
+        amrex::Print() << (nodal ? "Nodal" : "Cell-centered") << " Poisson:" << std::endl;
+        check_xdoty_norm_inf(nodal, geom, ba, dm);
+        for (auto const& pair : {std::make_pair(BottomSolver::cg, BottomSolver::pipecg),
+                                 std::make_pair(BottomSolver::bicgstab, BottomSolver::pipebicgstab)})
+        {
+            Result classic = solve(nodal, pair.first, geom, ba, dm, max_coarsening_level,
+                                   reltol, verbose, bottom_verbose);
+            Result pipelined = solve(nodal, pair.second, geom, ba, dm, max_coarsening_level,
+                                     reltol, verbose, bottom_verbose);
+
+            const Real phimax = classic.phi.norm0();
+            MultiFab::Subtract(pipelined.phi, classic.phi, 0, 0, 1, 0);
+            const Real diff = pipelined.phi.norm0() / phimax;
+
+            amrex::Print() << "  " << name(pair.first) << ": " << classic.niters
+                           << " iterations, " << classic.nbottom << " bottom iterations;  "
+                           << name(pair.second) << ": " << pipelined.niters
+                           << " iterations, " << pipelined.nbottom << " bottom iterations;"
+                           << "  relative difference " << diff << std::endl;
+
+            AMREX_ALWAYS_ASSERT(classic.nbottom > 0 && pipelined.nbottom > 0);
+            // Rounding differs, so pipelined CG may need some more iterations.
+            AMREX_ALWAYS_ASSERT(pipelined.nbottom <= 2*classic.nbottom);
+            AMREX_ALWAYS_ASSERT(std::abs(pipelined.niters - classic.niters) <= 1);
+            AMREX_ALWAYS_ASSERT(diff < Real(1.e-8));
+        }
+    }
+}
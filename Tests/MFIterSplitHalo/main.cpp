@@ -0,0 +1,173 @@
+#include <AMReX.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <map>
+#include <utility>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+struct Piece
+{
+    int index;
+    int local_tile;
+    int num_tiles;
+    Box bx;
+    bool halo;
+};
+
+// The interior and halo pieces of every tile must tile it exactly once.
+void check_cover (MultiFab const& mf, IntVect const& tile_size, IntVect const& width)
+{
+    std::map<std::pair<int,int>,Box> tiles;
+    for (MFIter mfi(mf, MFItInfo().EnableTiling(tile_size)); mfi.isValid(); ++mfi) {
+        tiles[std::make_pair(mfi.index(), mfi.LocalTileIndex())] = mfi.tilebox();
+    }
+
+    iMultiFab cnt(mf.boxArray(), mf.DistributionMap(), 1, 0);
+    cnt.setVal(0);
+
+    int nready = 0;
+    Vector<Piece> pieces;
+    auto ready = [&nready] () { ++nready; };
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(mf, MFItInfo().EnableTiling(tile_size).SplitHalo(width, ready));
+         mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        if (mfi.isHaloPhase()) {
+            AMREX_ALWAYS_ASSERT(nready == 1);
+        } else {
+            AMREX_ALWAYS_ASSERT(nready == 0);
+            AMREX_ALWAYS_ASSERT(amrex::grow(mfi.validbox(), -width).contains(bx));
+        }
+        auto const& a = cnt.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            a(i,j,k) += 1;
+        });
+#ifdef AMREX_USE_OMP
+#pragma omp critical (split_halo_pieces)
+#endif
+        pieces.push_back(Piece{mfi.index(), mfi.LocalTileIndex(), mfi.numLocalTiles(),
+                               bx, mfi.isHaloPhase()});
+    }
+
+    AMREX_ALWAYS_ASSERT(nready == 1);
+    AMREX_ALWAYS_ASSERT(cnt.min(0) == 1 && cnt.max(0) == 1);
+
+    std::map<std::pair<int,int>,Long> npts;
+    for (auto const& p : pieces) {
+        auto key = std::make_pair(p.index, p.local_tile);
+        AMREX_ALWAYS_ASSERT(tiles.count(key) == 1);
+        AMREX_ALWAYS_ASSERT(tiles[key].contains(p.bx));
+        AMREX_ALWAYS_ASSERT(p.local_tile < p.num_tiles);
+        npts[key] += p.bx.numPts();
+    }
+    AMREX_ALWAYS_ASSERT(npts.size() == tiles.size());
+    for (auto const& kv : tiles) {
+        AMREX_ALWAYS_ASSERT(npts[kv.first] == kv.second.numPts());
+    }
+
+    amrex::Print() << "  width " << width << ":  " << pieces.size() << " pieces on "
+                   << tiles.size() << " tiles ok" << std::endl;
+}
+
+void laplacian (MultiFab& out, MultiFab const& in, MFIter const& mfi)
+{
+    const Box& bx = mfi.tilebox();
+    auto const& u = in.const_array(mfi);
+    auto const& l = out.array(mfi);
+    amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+    {
+        l(i,j,k) = AMREX_D_TERM(u(i-1,j,k) + u(i+1,j,k),
+                              + u(i,j-1,k) + u(i,j+1,k),
+                              + u(i,j,k-1) + u(i,j,k+1))
+            - Real(2*AMREX_SPACEDIM) * u(i,j,k);
+    });
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    IntVect tile_size(AMREX_D_DECL(8,4,4));
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        Vector<int> ts;
+        if (pp.queryarr("tile_size", ts)) {
+            tile_size = IntVect(ts);
+        }
+    }
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, rb, 0, is_periodic);
+
+    MultiFab mf(ba, dm, 1, 1);
+
+    amrex::Print() << "Interior and halo cover:" << std::endl;
+    for (int w : {0, 1, 3, max_grid_size}) {
+        check_cover(mf, tile_size, IntVect(w));
+    }
+
+    amrex::Print() << "FillBoundary overlap:" << std::endl;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            a(i,j,k) = Real((i*7919 + j*104729 + k*1299709) % 1000);
+        });
+    }
+
+    MultiFab ref(ba, dm, 1, 0);
+    mf.FillBoundary(geom.periodicity());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(ref, MFItInfo().EnableTiling(tile_size)); mfi.isValid(); ++mfi) {
+        laplacian(ref, mf, mfi);
+    }
+
+    mf.setBndry(Real(-1.e30));
+    MultiFab res(ba, dm, 1, 0);
+    mf.FillBoundary_nowait(geom.periodicity());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(res, MFItInfo().EnableTiling(tile_size).OverlapFillBoundary(mf, IntVect(1)));
+         mfi.isValid(); ++mfi)
+    {
+        laplacian(res, mf, mfi);
+    }
+
+    MultiFab::Subtract(res, ref, 0, 0, 1, 0);
+    const Real err = res.norm0();
+    amrex::Print() << "  max difference = " << err << std::endl;
+    AMREX_ALWAYS_ASSERT(err == Real(0.));
+}
@@ -0,0 +1,208 @@
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_MemPool.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParmParse.H>
+
+#include <memory>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void fill (FArrayBox& fab, Real v)
+{
+    auto const& a = fab.array();
+    amrex::LoopOnCpu(fab.box(), fab.nComp(), [&] (int i, int j, int k, int n) noexcept
+    {
+        a(i,j,k,n) = v + Real(i+j+k+n);
+    });
+}
+
+bool intact (FArrayBox const& fab, Real v)
+{
+    bool r = true;
+    auto const& a = fab.const_array();
+    amrex::LoopOnCpu(fab.box(), fab.nComp(), [&] (int i, int j, int k, int n) noexcept
+    {
+        r = r && (a(i,j,k,n) == v + Real(i+j+k+n));
+    });
+    return r;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int nloops = 10;
+    bool bump = false;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nloops", nloops);
+        ParmParse ppa("amrex");
+        ppa.query("mempool_bump_alloc", bump);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    MultiFab mf(ba, dm, 1, 0);
+    mf.setVal(0.0);
+
+    BoxArray ba_inner(Box(IntVect(0), IntVect(n_cell/2-1)));
+    ba_inner.maxSize(max_grid_size/4);
+    MultiFab mf_inner(ba_inner, DistributionMapping(ba_inner), 1, 0);
+
+    MFIter::allowMultipleMFIters(true);
+
+    const int nthreads = OpenMP::get_max_threads();
+    Vector<void*> first_ptr(nthreads, nullptr);
+    int nbad = 0;
+    int nmoved = 0;
+    int mp_tot_1 = 0;
+
+    for (int iloop = 0; iloop < nloops; ++iloop)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel reduction(+:nbad,nmoved)
+#endif
+        {
+            const int tid = OpenMP::get_thread_num();
+            bool first = true;
+            for (MFIter mfi(mf, MFItInfo().EnableTiling(IntVect(8))); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                FArrayBox outer(bx, 2, The_MemPool_Arena());
+                fill(outer, Real(mfi.index()));
+
+                if (bump) {
+                    // With bump allocation, every iteration starts over at
+                    // the same place, once the first loop has sized the chunk.
+                    if (first && iloop <= 1) {
+                        first_ptr[tid] = outer.dataPtr();
+                    } else if (outer.dataPtr() != first_ptr[tid]) {
+                        ++nmoved;
+                    }
+                }
+                first = false;
+
+                // The inner loop allocates and releases scratch of its own,
+                // which must neither overlap nor reclaim the outer scratch.
+                for (MFIter mfi2(mf_inner); mfi2.isValid(); ++mfi2)
+                {
+                    FArrayBox inner(mfi2.validbox(), 3, The_MemPool_Arena());
+                    fill(inner, Real(-1-mfi2.index()));
+                    if (!intact(outer, Real(mfi.index()))) { ++nbad; }
+                    if (!intact(inner, Real(-1-mfi2.index()))) { ++nbad; }
+                }
+
+                FArrayBox after(bx, 1, The_MemPool_Arena());
+                fill(after, Real(1000));
+                if (!intact(outer, Real(mfi.index()))) { ++nbad; }
+
+                mf[mfi].plus<RunOn::Host>(outer, bx, 0, 0, 1);
+            }
+        }
+
+        // Outside of MFIter loops the pools are used as before.
+        {
+            void* p = amrex_mempool_alloc(1024);
+            amrex_mempool_free(p);
+        }
+
+        if (iloop == 1) {
+            int mp_min, mp_max;
+            amrex_mempool_get_stats(mp_min, mp_max, mp_tot_1);
+        }
+    }
+
+    int mp_min, mp_max, mp_tot;
+    amrex_mempool_get_stats(mp_min, mp_max, mp_tot);
+    amrex::Print() << "bump allocation " << (bump ? "on" : "off")
+                   << ", memory pools hold " << mp_tot << " MB" << std::endl;
+
+    AMREX_ALWAYS_ASSERT(nbad == 0);
+    AMREX_ALWAYS_ASSERT(nmoved == 0);
+    // Repeated loops must not grow the pools.
+    AMREX_ALWAYS_ASSERT(mp_tot == mp_tot_1);
+
+    // Every tile was added once per loop.
+    MultiFab ref(ba, dm, 1, 0);
+    for (MFIter mfi(ref); mfi.isValid(); ++mfi) {
+        auto const& a = ref.array(mfi);
+        const Real v = Real(mfi.index());
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            a(i,j,k) = Real(nloops) * (v + Real(i+j+k));
+        });
+    }
+    MultiFab::Subtract(ref, mf, 0, 0, 1, 0);
+    AMREX_ALWAYS_ASSERT(ref.norm0() == Real(0.));
+
+    // Buffers allocated inside a loop and kept after it, both from
+    // The_MemPool_Arena() and from The_Async_Arena(), which uses the pools
+    // inside OpenMP parallel regions, must survive later loops.
+    Vector<std::unique_ptr<FArrayBox> > kept(nthreads), kept_async(nthreads);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    {
+        const int tid = OpenMP::get_thread_num();
+        for (MFIter mfi(mf, MFItInfo().EnableTiling(IntVect(8))); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            FArrayBox scratch(bx, 1, The_MemPool_Arena());
+            fill(scratch, Real(-7));
+            if (!kept[tid]) {
+                kept[tid] = std::make_unique<FArrayBox>(bx, 2, The_MemPool_Arena());
+                fill(*kept[tid], Real(5000+tid));
+                kept_async[tid] = std::make_unique<FArrayBox>(bx, 2, The_Async_Arena());
+                fill(*kept_async[tid], Real(6000+tid));
+            }
+        }
+    }
+
+    for (int iloop = 0; iloop < 3; ++iloop)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(mf, MFItInfo().EnableTiling(IntVect(8))); mfi.isValid(); ++mfi)
+        {
+            FArrayBox scratch(mfi.tilebox(), 3, The_MemPool_Arena());
+            fill(scratch, Real(-8));
+        }
+    }
+
+    int nlost = 0;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel reduction(+:nlost)
+#endif
+    {
+        // Freed by the threads that allocated them
+        const int tid = OpenMP::get_thread_num();
+        if (kept[tid]) {
+            if (!intact(*kept[tid], Real(5000+tid))) { ++nlost; }
+            if (!intact(*kept_async[tid], Real(6000+tid))) { ++nlost; }
+            kept[tid].reset();
+            kept_async[tid].reset();
+        }
+    }
+    amrex::Print() << "buffers kept after their loop " << (nlost == 0 ? "intact" : "overwritten")
+                   << std::endl;
+    AMREX_ALWAYS_ASSERT(nlost == 0);
+}
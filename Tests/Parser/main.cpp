@@ -1,7 +1,9 @@
 #include <AMReX.H>
 #include <AMReX_Parser.H>
 #include <AMReX_IParser.H>
+#include <cmath>
 #include <map>
+#include <vector>
 
 using namespace amrex;
 
@@ -89,6 +91,75 @@ int test3 (std::string const& f,
             ++nfail;
         }
     }}}
+    // evalBatch over rows in z
+    std::vector<double> xb(N), yb(N), zb(N), rb(N);
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+        for (int k = 0; k < N; ++k) {
+            xb[k] = lo[0] + i*dx[0];
+            yb[k] = lo[1] + j*dx[1];
+            zb[k] = lo[2] + k*dx[2];
+        }
+        exe.evalBatch(N, {xb.data(), yb.data(), zb.data()}, rb.data());
+        for (int k = 0; k < N; ++k) {
+            double benchmark = fb(xb[k],yb[k],zb[k]);
+            double abserror = std::abs(rb[k]-benchmark);
+            double relerror = abserror / (1.e-50 + std::max(std::abs(rb[k]),std::abs(benchmark)));
+            if (abserror > abstol && relerror > reltol) {
+                amrex::Print() << "    batch f(" << xb[k] << "," << yb[k] << "," << zb[k] << ") = "
+                               << rb[k] << ", " << benchmark << "\n";
+                ++nfail;
+            }
+        }
+    }}
+    if (nfail > 0) {
+        amrex::Print() << "    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
+template <typename F>
+int test3d (std::string const& f, std::string const& var,
+            std::map<std::string,Real> const& constants,
+            Vector<std::string> const& variables,
+            F && fb, Array<Real,3> const& lo, Array<Real,3> const& hi,
+            int N, Real reltol, Real abstol)
+{
+    amrex::Print() << test_number++ << ". Testing d(\"" << f << "\")/d" << var << "   ";
+
+    Parser parser(f);
+    for (auto const& kv : constants) {
+        parser.setConstant(kv.first, kv.second);
+    }
+    parser.registerVariables(variables);
+    Parser dparser = parser.derivative(var);
+    auto const exe = dparser.compile<3>();
+    max_stack_size = std::max(max_stack_size, dparser.maxStackSize());
+
+    GpuArray<Real,3> dx{AMREX_D_DECL((hi[0]-lo[0]) / (N-1),
+                                     (hi[1]-lo[1]) / (N-1),
+                                     (hi[2]-lo[2]) / (N-1))};
+
+    int nfail = 0;
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+    for (int k = 0; k < N; ++k) {
+        Real x = lo[0] + i*dx[0];
+        Real y = lo[1] + j*dx[1];
+        Real z = lo[2] + k*dx[2];
+        double result = exe(x,y,z);
+        double benchmark = fb(x,y,z);
+        double abserror = std::abs(result-benchmark);
+        double relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
+        if (abserror > abstol && relerror > reltol) {
+            amrex::Print() << "    df(" << x << "," << y << "," << z << ") = " << result << ", "
+                           << benchmark << "\n";
+            ++nfail;
+        }
+    }}}
     if (nfail > 0) {
         amrex::Print() << "    failed " << nfail << " times\n";
         return 1;
@@ -147,6 +218,147 @@ int test4 (std::string const& f,
     }
 }
 
+// f has repeated subtrees that CSE hoists into locals, and g is f written
+// with those locals.  They must give the same bits, from both the scalar
+// and the batch evaluation.
+template <typename F>
+int testcse (std::string const& f, std::string const& g,
+             F && fb, Array<Real,3> const& lo, Array<Real,3> const& hi,
+             int N, Real reltol, Real abstol)
+{
+    amrex::Print() << test_number++ << ". Testing CSE of \"" << f << "\"   ";
+
+    Parser fparser(f);
+    fparser.registerVariables({"x","y","z"});
+    auto const fexe = fparser.compile<3>();
+    Parser gparser(g);
+    gparser.registerVariables({"x","y","z"});
+    auto const gexe = gparser.compile<3>();
+    max_stack_size = std::max(max_stack_size, fparser.maxStackSize());
+
+    GpuArray<Real,3> dx{(hi[0]-lo[0]) / (N-1),
+                        (hi[1]-lo[1]) / (N-1),
+                        (hi[2]-lo[2]) / (N-1)};
+    int nfail = 0;
+    std::vector<double> xb(N), yb(N), zb(N), rb(N);
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+        for (int k = 0; k < N; ++k) {
+            xb[k] = lo[0] + i*dx[0];
+            yb[k] = lo[1] + j*dx[1];
+            zb[k] = lo[2] + k*dx[2];
+        }
+        fexe.evalBatch(N, {xb.data(), yb.data(), zb.data()}, rb.data());
+        for (int k = 0; k < N; ++k) {
+            double result = fexe(xb[k],yb[k],zb[k]);
+            double expected = gexe(xb[k],yb[k],zb[k]);
+            double benchmark = fb(xb[k],yb[k],zb[k]);
+            double abserror = std::abs(result-benchmark);
+            double relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
+            if (result != expected || rb[k] != expected ||
+                (abserror > abstol && relerror > reltol)) {
+                amrex::Print() << "    f(" << xb[k] << "," << yb[k] << "," << zb[k] << ") = "
+                               << result << ", batch " << rb[k] << ", " << expected << ", "
+                               << benchmark << "\n";
+                ++nfail;
+            }
+        }
+    }}
+    if (nfail > 0) {
+        amrex::Print() << "    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
+// The points of each batch take different branches of if(), except for
+// those of the first batch.  Batch and scalar evaluation must agree bitwise.
+int testbatch (std::string const& f, int N)
+{
+    amrex::Print() << test_number++ << ". Testing batches of \"" << f << "\"   ";
+
+    Parser parser(f);
+    parser.registerVariables({"x"});
+    auto const exe = parser.compile<1>();
+    max_stack_size = std::max(max_stack_size, parser.maxStackSize());
+
+    std::vector<double> xb(N), rb(N);
+    for (int n = 0; n < N; ++n) {
+        xb[n] = (n < AMREX_PARSER_BATCH_SIZE) ? -1.0-0.01*n : std::sin(1.7*n);
+    }
+    exe.evalBatch(N, {xb.data()}, rb.data());
+    int nfail = 0;
+    for (int n = 0; n < N; ++n) {
+        double result = exe(xb[n]);
+        if (rb[n] != result || std::isnan(result)) {
+            amrex::Print() << "    f(" << xb[n] << ") = " << result << ", batch " << rb[n] << "\n";
+            ++nfail;
+        }
+    }
+    if (nfail > 0) {
+        amrex::Print() << "    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
+// The derivative of a parser that has already been compiled, and so has
+// had its common subexpressions eliminated, is eliminated again when it is
+// compiled.  It must agree with the derivative of a parser that has not.
+template <typename F>
+int testcse2 (std::string const& f, std::string const& var,
+              F && fb, Array<Real,3> const& lo, Array<Real,3> const& hi,
+              int N, Real reltol, Real abstol)
+{
+    amrex::Print() << test_number++ << ". Testing d(\"" << f << "\")/d" << var
+                   << " after CSE   ";
+
+    Parser parser(f);
+    parser.registerVariables({"x","y","z"});
+    parser.compile<3>();
+    Parser dparser = parser.derivative(var);
+    auto const exe = dparser.compile<3>();
+    max_stack_size = std::max(max_stack_size, dparser.maxStackSize());
+
+    Parser parser2(f);
+    parser2.registerVariables({"x","y","z"});
+    Parser dparser2 = parser2.derivative(var);
+    auto const exe2 = dparser2.compile<3>();
+
+    GpuArray<Real,3> dx{(hi[0]-lo[0]) / (N-1),
+                        (hi[1]-lo[1]) / (N-1),
+                        (hi[2]-lo[2]) / (N-1)};
+    int nfail = 0;
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+    for (int k = 0; k < N; ++k) {
+        Real x = lo[0] + i*dx[0];
+        Real y = lo[1] + j*dx[1];
+        Real z = lo[2] + k*dx[2];
+        double result = exe(x,y,z);
+        for (double benchmark : {double(exe2(x,y,z)), double(fb(x,y,z))}) {
+            double abserror = std::abs(result-benchmark);
+            double relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
+            if (abserror > abstol && relerror > reltol) {
+                amrex::Print() << "    df(" << x << "," << y << "," << z << ") = " << result << ", "
+                               << benchmark << "\n";
+                ++nfail;
+            }
+        }
+    }}}
+    if (nfail > 0) {
+        amrex::Print() << "    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc, argv);
@@ -356,6 +568,62 @@ int main (int argc, char* argv[])
                         {0.e-6, 0.0, -20.e-6}, {20.e-6, 1.e-10, 20.e-6}, 100,
                         1.e-12, 1.e-15);
 
+        nerror += test3d("r=sqrt(x*x+y*y+z*z); r - a - b*sin(5*x)*cos(4*y)*exp(z)", "x",
+                         {{"a",0.6},{"b",0.1}},
+                         {"x","y","z"},
+                         [=] (Real x, Real y, Real z) -> Real {
+                             Real b = 0.1;
+                             Real r = std::sqrt(x*x+y*y+z*z);
+                             return x/r - 5.*b*std::cos(5*x)*std::cos(4*y)*std::exp(z);
+                         },
+                         {0.1, 0.2, 0.3}, {1.0, 1.1, 1.2}, 20,
+                         1.e-12, 1.e-15);
+
+        nerror += test3d("if(x<y, x*y*z, y^3/log(1+z)) + atan(y/x) + max(x,z)", "y",
+                         {},
+                         {"x","y","z"},
+                         [=] (Real x, Real y, Real z) -> Real {
+                             Real r = (x<y) ? x*z : 3.*y*y/std::log(1.+z);
+                             return r + x/(x*x+y*y);
+                         },
+                         {0.1, 0.15, 0.3}, {1.0, 1.05, 1.2}, 20,
+                         1.e-12, 1.e-15);
+
+        nerror += testcse("sin(x*y+z)*sin(x*y+z) + exp(sin(x*y+z))*(x*y+z) + (x-y)^2/(1+(x-y)^2)",
+                          "a=x*y+z; s=sin(a); d=(x-y)^2; s*s + exp(s)*a + d/(1+d)",
+                          [=] (Real x, Real y, Real z) -> Real {
+                              Real a = x*y+z;
+                              Real s = std::sin(a);
+                              Real d = (x-y)*(x-y);
+                              return s*s + std::exp(s)*a + d/(1+d);
+                          },
+                          {-1.0, -0.5, 0.1}, {1.0, 1.5, 0.9}, 70,
+                          1.e-14, 1.e-15);
+
+        nerror += testcse("r=sqrt(x*x+y*y); if(r<0.5, cos(r)*cos(r), sqrt(x*x+y*y)*exp(-z)) + cos(r)",
+                          "r=sqrt(x*x+y*y); c=cos(r); if(r<0.5, c*c, r*exp(-z)) + c",
+                          [=] (Real x, Real y, Real z) -> Real {
+                              Real r = std::sqrt(x*x+y*y);
+                              Real c = std::cos(r);
+                              return ((r<0.5) ? c*c : r*std::exp(-z)) + c;
+                          },
+                          {-1.0, -1.0, 0.0}, {1.0, 1.0, 1.0}, 70,
+                          1.e-14, 1.e-15);
+
+        nerror += testbatch("if(x<0, -x*exp(x), if(x<0.5, sqrt(x), log(x)))", 300);
+
+        nerror += testbatch("r=if(x<0.3, 0, x-0.3); if(r>0, log(r)*x, 2*x) + r", 257);
+
+        nerror += testcse2("sin(x*y+z)*sin(x*y+z) + exp(sin(x*y+z))*(x*y+z)", "x",
+                           [=] (Real x, Real y, Real z) -> Real {
+                               Real a = x*y+z;
+                               Real s = std::sin(a);
+                               Real c = std::cos(a);
+                               return 2.*s*c*y + std::exp(s)*c*y*a + std::exp(s)*y;
+                           },
+                           {-1.0, -0.5, 0.1}, {1.0, 1.5, 0.9}, 20,
+                           1.e-12, 1.e-14);
+
         amrex::Print() << "\nMax stack size is " << max_stack_size << "\n";
         if (nerror > 0) {
             amrex::Print() << nerror << " tests failed\n";
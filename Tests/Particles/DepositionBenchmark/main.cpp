@@ -0,0 +1,109 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+#include <AMReX_ParticleInterpolators.H>
+
+using namespace amrex;
+
+using MyParticleContainer = ParticleContainer<1+AMREX_SPACEDIM, 0>;
+
+// Deposit the mass and the mass weighted velocity nsteps times and return
+// the time per deposition.
+Real deposit (MyParticleContainer const& pc, MultiFab& mf, Geometry const& geom,
+              IntVect const& block_size, int nsteps)
+{
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    auto f = [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
+                                   amrex::Array4<amrex::Real> const& rho)
+    {
+        ParticleInterpolator::Linear interp(p, plo, dxi);
+        interp.ParticleToMesh(p, rho, 0, 0, 1,
+            [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+            {
+                return part.rdata(comp);
+            });
+        interp.ParticleToMesh(p, rho, 1, 1, AMREX_SPACEDIM,
+            [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+            {
+                return part.rdata(0) * part.rdata(comp);
+            });
+    };
+
+    // warm up
+    amrex::ParticleToMesh(pc, mf, 0, f, true, block_size);
+
+    Gpu::synchronize();
+    Real t0 = amrex::second();
+    for (int istep = 0; istep < nsteps; ++istep) {
+        amrex::ParticleToMesh(pc, mf, 0, f, true, block_size);
+    }
+    Gpu::synchronize();
+    Real t = amrex::second() - t0;
+    ParallelDescriptor::ReduceRealMax(t);
+    return t / nsteps;
+}
+
+void testDeposition ()
+{
+    ParmParse pp;
+    int nx, ny, nz, max_grid_size;
+    pp.get("nx", nx);
+    pp.get("ny", ny);
+    pp.get("nz", nz);
+    pp.get("max_grid_size", max_grid_size);
+    std::vector<Real> nppcs;
+    pp.getarr("nppc", nppcs);
+    int nsteps = 5;
+    pp.query("nsteps", nsteps);
+    std::vector<int> bs(AMREX_SPACEDIM, 8);
+    pp.queryarr("block_size", bs);
+    bool sort_particles = true;
+    pp.query("sort_particles", sort_particles);
+    const IntVect block_size(AMREX_D_DECL(bs[0],bs[1],bs[2]));
+
+    RealBox real_box({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    const Box domain(IntVect(0), IntVect(AMREX_D_DECL(nx-1,ny-1,nz-1)));
+    Geometry geom(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab blocked(ba, dm, 1+AMREX_SPACEDIM, 1);
+    MultiFab unblocked(ba, dm, 1+AMREX_SPACEDIM, 1);
+
+    for (Real nppc : nppcs)
+    {
+        MyParticleContainer pc(geom, dm, ba);
+        const Long num_particles = static_cast<Long>(nppc * domain.numPts());
+        MyParticleContainer::ParticleInitData pdata
+            = {{1.0, AMREX_D_DECL(1.0, 2.0, 3.0)}, {},{},{}};
+        pc.InitRandom(num_particles, 451, pdata, false);
+        if (sort_particles) { pc.SortParticlesByCell(); }
+
+        const Real t_blocked = deposit(pc, blocked, geom, block_size, nsteps);
+        const Real t_default = deposit(pc, unblocked, geom, IntVect(0), nsteps);
+
+        MultiFab::Subtract(unblocked, blocked, 0, 0, unblocked.nComp(), 0);
+        const Real diff = unblocked.norm0(0, 0) / blocked.norm0(0, 0);
+
+        amrex::Print() << "nppc = " << nppc << ", " << num_particles << " particles\n"
+                       << "    blocked deposition: " << t_blocked << " s, "
+                       << num_particles / t_blocked << " particles/s\n"
+                       << "    default deposition: " << t_default << " s, "
+                       << num_particles / t_default << " particles/s\n"
+                       << "    relative difference in mass: " << diff << "\n";
+
+        AMREX_ALWAYS_ASSERT(diff < 1.e-12);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    testDeposition();
+    amrex::Finalize();
+}
@@ -4,6 +4,9 @@
 #include "CheckPair.H"
 #include <AMReX_SPACE.H>
 
+#include <algorithm>
+#include <vector>
+
 using namespace amrex;
 
 namespace
@@ -227,6 +230,36 @@ void MDParticleContainer::moveParticles(amrex::ParticleReal dx)
     }
 }
 
+void MDParticleContainer::jiggleParticles(amrex::ParticleReal amplitude, int step)
+{
+    BL_PROFILE("MDParticleContainer::jiggleParticles");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+
+        auto& ptile = plev[std::make_pair(gid, tid)];
+        auto& aos   = ptile.GetArrayOfStructs();
+        ParticleType* pstruct = aos().dataPtr();
+
+        const size_t np = aos.numParticles();
+
+        // each particle moves differently, but deterministically
+        AMREX_FOR_1D ( np, i,
+        {
+            ParticleType& p = pstruct[i];
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                p.pos(idim) += amplitude * static_cast<ParticleReal>
+                    (std::sin(0.37*p.id() + 0.1*step + 2.1*idim));
+            }
+        });
+    }
+}
+
 void MDParticleContainer::writeParticles(const int n)
 {
     BL_PROFILE("MDParticleContainer::writeParticles");
@@ -369,6 +402,149 @@ void MDParticleContainer::checkNeighborList()
     amrex::PrintToFile("neighbor_test") << "All the neighbor list particles match!" << std::endl;
 }
 
+void MDParticleContainer::checkVerletNeighborList(amrex::Real cutoff)
+{
+    BL_PROFILE("MDParticleContainer::checkVerletNeighborList");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+
+        const int np       = aos.numParticles();
+        const int np_total = aos.numTotalParticles();
+
+        amrex::Gpu::HostVector<ParticleType> h_pstruct(np_total);
+        Gpu::copy(Gpu::deviceToHost, aos().dataPtr(), aos().dataPtr() + np_total, h_pstruct.begin());
+
+        auto& d_counts = m_neighbor_list[lev][index].GetCounts();
+        Gpu::HostVector<unsigned int> h_counts(d_counts.size());
+        Gpu::copy(Gpu::deviceToHost, d_counts.begin(), d_counts.end(), h_counts.begin());
+
+        auto& d_list = m_neighbor_list[lev][index].GetList();
+        Gpu::HostVector<unsigned int> h_list(d_list.size());
+        Gpu::copy(Gpu::deviceToHost, d_list.begin(), d_list.end(), h_list.begin());
+
+        // every pair that is within the cutoff now must be in the list
+        unsigned start = 0;
+        for (int i = 0; i < np; i++)
+        {
+            ParticleType& p1 = h_pstruct[i];
+            auto begin = h_list.begin() + start;
+            auto end   = begin + h_counts[i];
+            for (int j = 0; j < np_total; j++)
+            {
+                if ( i == j ) continue;
+
+                ParticleType& p2 = h_pstruct[j];
+                AMREX_D_TERM(Real dx = p1.pos(0) - p2.pos(0);,
+                             Real dy = p1.pos(1) - p2.pos(1);,
+                             Real dz = p1.pos(2) - p2.pos(2);)
+
+                Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+
+                if (r2 <= cutoff*cutoff)
+                {
+                    AMREX_ALWAYS_ASSERT(std::find(begin, end, static_cast<unsigned int>(j)) != end);
+                }
+            }
+            start += h_counts[i];
+        }
+    }
+}
+
+void MDParticleContainer::checkCellList(amrex::Real cutoff)
+{
+    BL_PROFILE("MDParticleContainer::checkCellList");
+
+    const int lev = 0;
+    const Geometry& geom = Geom(lev);
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+
+        const int np       = aos.numParticles();
+        const int np_total = aos.numTotalParticles();
+
+        amrex::Gpu::HostVector<ParticleType> h_pstruct(np_total);
+        Gpu::copy(Gpu::deviceToHost, aos().dataPtr(), aos().dataPtr() + np_total, h_pstruct.begin());
+
+        // count the neighbors of each particle by brute force
+        std::vector<int> expected(np, 0);
+        for (int i = 0; i < np; i++)
+        {
+            for (int j = 0; j < np_total; j++)
+            {
+                if ( i == j ) continue;
+
+                AMREX_D_TERM(Real dx = h_pstruct[i].pos(0) - h_pstruct[j].pos(0);,
+                             Real dy = h_pstruct[i].pos(1) - h_pstruct[j].pos(1);,
+                             Real dz = h_pstruct[i].pos(2) - h_pstruct[j].pos(2);)
+
+                Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+                if (r2 <= cutoff*cutoff) ++expected[i];
+            }
+        }
+
+        CellList<ParticleType> cell_list;
+        cell_list.build(ptile, amrex::grow(mfi.tilebox(), m_num_neighbor_cells), geom,
+                        {PIdx::vx});
+
+        const auto real = cell_list.real();
+        AMREX_ALWAYS_ASSERT(cell_list.numRealParticles() == np);
+        AMREX_ALWAYS_ASSERT(cell_list.numGhostParticles() == np_total - np);
+        for (int i = 0; i < np; i++)
+        {
+            const ParticleType& p = h_pstruct[real.index[i]];
+            AMREX_ALWAYS_ASSERT(real.pos[0][i] == p.pos(0) &&
+                                real.rdata[0][i] == p.rdata(PIdx::vx));
+        }
+
+        for (int half = 0; half < 2; ++half)
+        {
+            std::vector<int> counts(np, 0);
+            cell_list.forEachNeighborBlock(m_num_neighbor_cells, half,
+                [&] (int i, CellListBlock const& nbrs, int jbegin, int jend)
+                {
+                    for (int j = jbegin; j < jend; ++j)
+                    {
+                        AMREX_D_TERM(Real dx = real.pos[0][i] - nbrs.pos[0][j];,
+                                     Real dy = real.pos[1][i] - nbrs.pos[1][j];,
+                                     Real dz = real.pos[2][i] - nbrs.pos[2][j];)
+
+                        Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+                        if (r2 <= cutoff*cutoff)
+                        {
+                            ++counts[real.index[i]];
+                            if (half && !nbrs.ghost) ++counts[nbrs.index[j]];
+                        }
+                    }
+                });
+
+            for (int i = 0; i < np; i++)
+            {
+                AMREX_ALWAYS_ASSERT(counts[i] == expected[i]);
+            }
+        }
+    }
+}
+
 void MDParticleContainer::reset_test_id()
 {
     BL_PROFILE("MDParticleContainer::reset_test_id");
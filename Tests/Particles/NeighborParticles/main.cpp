@@ -23,6 +23,10 @@ void testNeighborParticles();
 
 void testNeighborList();
 
+void testVerletNeighborList();
+
+void testCellList();
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
@@ -33,6 +37,12 @@ int main (int argc, char* argv[])
     amrex::PrintToFile("neighbor_test") << "Running neighbor list test \n";
     testNeighborList();
 
+    amrex::PrintToFile("neighbor_test") << "Running Verlet neighbor list test \n";
+    testVerletNeighborList();
+
+    amrex::PrintToFile("neighbor_test") << "Running cell list test \n";
+    testCellList();
+
     amrex::Finalize();
 }
 
@@ -191,3 +201,113 @@ void testNeighborList ()
                              {"dummy"}, geom, 0.0, 0);
     pc.WritePlotFile("NeighborParticles_plt00001", "neighbors");
 }
+
+void testVerletNeighborList ()
+{
+    BL_PROFILE("testVerletNeighborList");
+    TestParams params;
+    get_test_params(params, "verlet");
+
+    ParmParse pp("verlet");
+    Real cutoff = 0.6;
+    Real skin = 0.3;
+    Real amplitude = 0.02;
+    int nsteps = 20;
+    pp.query("cutoff", cutoff);
+    pp.query("skin", skin);
+    pp.query("amplitude", amplitude);
+    pp.query("nsteps", nsteps);
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    // the neighbor cells must cover the cutoff plus the skin
+    const int ncells = 1;
+    AMREX_ALWAYS_ASSERT(cutoff + skin <= ncells*geom.CellSize(0));
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+    pc.InitParticles(nppc, 1.0, 0.0);
+
+    const CheckPairWithin check_pair{(cutoff+skin)*(cutoff+skin)};
+
+    int nrebuilds = 0;
+    for (int step = 0; step < nsteps; ++step)
+    {
+        if (pc.updateNeighborList(check_pair, static_cast<ParticleReal>(skin))) {
+            ++nrebuilds;
+        }
+        pc.checkVerletNeighborList(cutoff);
+        pc.jiggleParticles(static_cast<ParticleReal>(amplitude), step);
+    }
+
+    amrex::PrintToFile("neighbor_test") << "The Verlet neighbor list was built " << nrebuilds
+                                        << " times in " << nsteps << " steps\n";
+    AMREX_ALWAYS_ASSERT(nrebuilds > 1 && nrebuilds < nsteps);
+
+    amrex::PrintToFile("neighbor_test") << "All the Verlet neighbor list pairs are found!" << std::endl;
+}
+
+void testCellList ()
+{
+    BL_PROFILE("testCellList");
+    TestParams params;
+    get_test_params(params, "cell_list");
+
+    ParmParse pp("cell_list");
+    Real cutoff = 0.9;
+    pp.query("cutoff", cutoff);
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncells = 1;
+    AMREX_ALWAYS_ASSERT(cutoff <= ncells*geom.CellSize(0));
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+    pc.InitParticles(nppc, 1.0, 0.0);
+
+    pc.fillNeighbors();
+    pc.checkCellList(cutoff);
+
+    amrex::PrintToFile("neighbor_test") << "All the cell list pairs are found!" << std::endl;
+}
@@ -0,0 +1,160 @@
+/*
+ * Compares FillBoundary with fabarray.persistent_fillboundary = 1 with the
+ * non-persistent FillBoundary, bitwise, including the ghost cells:
+ * - repeated calls with different numbers of components, which share the
+ *   FB of the BoxArray and DistributionMapping but not its plans;
+ * - periodic and non-periodic directions;
+ * - two overlapping FillBoundary_nowait on FabArrays with the same
+ *   BoxArray and DistributionMapping, finished in either order.
+ */
+
+#include <AMReX.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+// Distinct values in the valid cells and garbage in the ghost cells
+void init_data (MultiFab& mf, int offset)
+{
+    mf.setVal(Real(-1.e30));
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = Real((i*7919 + j*104729 + k*1299709 + (n+offset)*15485863) % 100003);
+        });
+    }
+}
+
+// Largest difference between a and b, including ghost cells
+Real max_diff (MultiFab const& a, MultiFab const& b)
+{
+    const IntVect ng = a.nGrowVect();
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), ng);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), ng);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), ng);
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norm0(n, ng.max(), true));
+    }
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+// mf after a non-persistent FillBoundary of [scomp,scomp+ncomp) with ng ghost cells
+MultiFab reference (MultiFab const& mf, int scomp, int ncomp, IntVect const& ng,
+                    Periodicity const& period)
+{
+    MultiFab r(mf.boxArray(), mf.DistributionMap(), mf.nComp(), mf.nGrowVect());
+    MultiFab::Copy(r, mf, 0, 0, mf.nComp(), mf.nGrowVect());
+    FabArrayBase::persistent_fillboundary = false;
+    r.FillBoundary(scomp, ncomp, ng, period);
+    FabArrayBase::persistent_fillboundary = true;
+    return r;
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 32;
+    int max_grid_size = 8;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    // Set by fabarray.persistent_fillboundary in the inputs
+    AMREX_ALWAYS_ASSERT(FabArrayBase::persistent_fillboundary);
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,1)};
+    Geometry geom(domain, rb, 0, is_periodic);
+    const Periodicity& period = geom.periodicity();
+
+    const int nc = 3;
+    const IntVect ng(2);
+
+    amrex::Print() << "Repeated FillBoundary:" << std::endl;
+    {
+        MultiFab mf(ba, dm, nc, ng);
+        // The plan of an FB is built on its second use, and used from then on.
+        const Vector<int> scomps{0, 0, 1, 0, 2, 0, 0, 1, 0};
+        const Vector<int> ncomps{3, 3, 2, 1, 1, 3, 2, 2, 3};
+        for (int i = 0; i < scomps.size(); ++i) {
+            init_data(mf, i);
+            MultiFab ref = reference(mf, scomps[i], ncomps[i], ng, period);
+            mf.FillBoundary(scomps[i], ncomps[i], ng, period);
+            const Real diff = max_diff(mf, ref);
+            amrex::Print() << "  scomp " << scomps[i] << ", ncomp " << ncomps[i]
+                           << ": difference " << diff << std::endl;
+            AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+        }
+
+        // Fewer ghost cells than mf has, which is another FB
+        for (int i = 0; i < 3; ++i) {
+            init_data(mf, 10+i);
+            MultiFab ref = reference(mf, 0, nc, IntVect(1), period);
+            mf.FillBoundary(0, nc, IntVect(1), period);
+            const Real diff = max_diff(mf, ref);
+            amrex::Print() << "  1 ghost cell: difference " << diff << std::endl;
+            AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+        }
+
+        if (ParallelDescriptor::NProcs() > 1) {
+            auto const& fb = mf.getFB(ng, period);
+            for (int ncomp : {1, 2, 3}) {
+                AMREX_ALWAYS_ASSERT(fb.m_persistent.count(ncomp*sizeof(Real)) == 1);
+            }
+        }
+    }
+
+    amrex::Print() << "Overlapping FillBoundary_nowait:" << std::endl;
+    {
+        MultiFab a(ba, dm, nc, ng);
+        MultiFab b(ba, dm, nc, ng);
+        for (int i = 0; i < 4; ++i) {
+            init_data(a, 20+i);
+            init_data(b, 30+i);
+            const int bcomp = (i < 2) ? nc : 1;
+            MultiFab aref = reference(a, 0, nc, ng, period);
+            MultiFab bref = reference(b, 0, bcomp, ng, period);
+
+            a.FillBoundary_nowait(0, nc, ng, period);
+            b.FillBoundary_nowait(0, bcomp, ng, period);
+            if (i % 2 == 0) {
+                b.FillBoundary_finish();
+                a.FillBoundary_finish();
+            } else {
+                a.FillBoundary_finish();
+                b.FillBoundary_finish();
+            }
+
+            const Real diff = std::max(max_diff(a, aref), max_diff(b, bref));
+            amrex::Print() << "  ncomp " << nc << " and " << bcomp
+                           << (i % 2 == 0 ? ", finished in reverse order" : ", finished in order")
+                           << ": difference " << diff << std::endl;
+            AMREX_ALWAYS_ASSERT(diff == Real(0.0));
+        }
+    }
+}
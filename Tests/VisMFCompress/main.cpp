@@ -0,0 +1,173 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+namespace {
+
+void check (MultiFab const& a, MultiFab const& b, Real tol, std::string const& what)
+{
+    MultiFab diff(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrowVect());
+    MultiFab::Copy(diff, a, 0, 0, a.nComp(), a.nGrowVect());
+    MultiFab::Subtract(diff, b, 0, 0, a.nComp(), a.nGrowVect());
+    Real err = diff.norminf(0, a.nComp(), a.nGrowVect());
+    amrex::Print() << "  " << what << ":  max error = " << err << std::endl;
+    AMREX_ALWAYS_ASSERT(err <= tol);
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncomp = 3;
+    MultiFab mf(ba, dm, ncomp, 1);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.fabbox(), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            // smooth data in component 0, constant in 1, rough in 2
+            Real x = Real(i+2*j+3*k) / Real(n_cell);
+            if (n == 0) {
+                a(i,j,k,n) = std::sin(x) + Real(1.e-3) * x * x;
+            } else if (n == 1) {
+                a(i,j,k,n) = Real(3.0);
+            } else {
+                a(i,j,k,n) = Real((i*7919 + j*104729 + k*1299709) % 1000) * Real(1.e-2);
+            }
+        });
+    }
+
+    amrex::UtilCreateDirectoryDestructive("vismfcompress");
+
+    VisMF::Header::Version oldVersion = VisMF::GetHeaderVersion();
+    VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+
+    amrex::Print() << "Compressed_v1 round trips:" << std::endl;
+    {
+        VisMF::SetCompressionTolerance(0.0);
+        VisMF::Write(mf, "vismfcompress/lossless");
+        MultiFab mf2(ba, dm, ncomp, 1);
+        VisMF::Read(mf2, "vismfcompress/lossless");
+        check(mf, mf2, 0.0, "lossless");
+    }
+
+    {
+        const Real tol = 1.e-4;
+        VisMF::SetCompressionTolerance(tol);
+        VisMF::Write(mf, "vismfcompress/lossy");
+        MultiFab mf2(ba, dm, ncomp, 1);
+        VisMF::Read(mf2, "vismfcompress/lossy");
+        check(mf, mf2, tol*(1.0+1.e-6), "lossy");
+        VisMF::SetCompressionTolerance(0.0);
+    }
+
+    {
+        VisMF::AsyncWrite(mf, "vismfcompress/async", true);
+        AsyncOut::Finish();
+        ParallelDescriptor::Barrier();
+        MultiFab mf2(ba, dm, ncomp, 0);
+        VisMF::Read(mf2, "vismfcompress/async");
+        MultiFab valid(ba, dm, ncomp, 0);
+        MultiFab::Copy(valid, mf, 0, 0, ncomp, 0);
+        check(valid, mf2, 0.0, "async");
+    }
+
+    {
+        // ---- single component reads decompress through a temporary
+        VisMF vmf("vismfcompress/lossless");
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const FArrayBox& fab = vmf.GetFab(mfi.index(), 2);
+            auto const& a = fab.const_array();
+            auto const& b = mf.const_array(mfi);
+            amrex::LoopOnCpu(fab.box(), [&] (int i, int j, int k) noexcept
+            {
+                AMREX_ALWAYS_ASSERT(a(i,j,k) == b(i,j,k,2));
+            });
+            vmf.clear(mfi.index(), 2);
+        }
+        amrex::Print() << "  single component:  ok" << std::endl;
+    }
+
+    amrex::Print() << "Memory mapped reads:" << std::endl;
+    VisMF::SetUseMemoryMappedReads(true);
+    {
+        MultiFab mf2(ba, dm, ncomp, 1);
+        VisMF::Read(mf2, "vismfcompress/lossless");
+        check(mf, mf2, 0.0, "compressed");
+    }
+
+    for (auto vers : {VisMF::Header::Version_v1, VisMF::Header::NoFabHeader_v1}) {
+        VisMF::SetHeaderVersion(vers);
+        std::string name = "vismfcompress/mapped" + std::to_string(vers);
+        VisMF::Write(mf, name);
+        MultiFab mf2(ba, dm, ncomp, 1);
+        VisMF::Read(mf2, name);
+        check(mf, mf2, 0.0, "version " + std::to_string(vers));
+
+        // ---- native data can be aliased without a copy
+        VisMF vmf(name);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            std::unique_ptr<FArrayBox> fab(vmf.mapFAB(mfi.index(), 1));
+            // ---- Version_v1 fab headers are text, so its fabs may be misaligned
+            if (vers == VisMF::Header::NoFabHeader_v1) {
+                AMREX_ALWAYS_ASSERT(fab != nullptr);
+            }
+            if (fab) {
+                auto const& a = fab->const_array();
+                auto const& b = mf.const_array(mfi);
+                amrex::LoopOnCpu(fab->box(), [&] (int i, int j, int k) noexcept
+                {
+                    AMREX_ALWAYS_ASSERT(a(i,j,k) == b(i,j,k,1));
+                });
+            }
+        }
+    }
+
+    {
+        // ---- rewriting a file that Read has mapped must not leave a stale mapping
+        std::string name = "vismfcompress/rewrite";
+        VisMF::SetHeaderVersion(VisMF::Header::NoFabHeader_v1);
+        VisMF::Write(mf, name);
+        VisMF vmf(name);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            vmf.GetFab(mfi.index(), 0);
+            vmf.clear(mfi.index(), 0);
+        }
+        MultiFab mf3(ba, dm, ncomp, 1);
+        mf3.setVal(1.0);
+        MultiFab::Add(mf3, mf, 0, 0, ncomp, 1);
+        VisMF::Write(mf3, name);
+        MultiFab mf2(ba, dm, ncomp, 1);
+        VisMF::Read(mf2, name);
+        check(mf3, mf2, 0.0, "rewritten");
+        VisMF::CloseAllStreams();
+    }
+    VisMF::SetUseMemoryMappedReads(false);
+
+    VisMF::SetHeaderVersion(oldVersion);
+}